@@ -0,0 +1,41 @@
+#include "budget.hpp"
+#include <algorithm>
+#include <cmath>
+
+float EmissionBudget::pressure(size_t free, size_t capacity) const {
+    if (capacity == 0 || soft_headroom <= 0.0f) return free > 0 ? 0.0f : 1.0f;
+
+    float headroom = static_cast<float>(free) / capacity;
+    return std::clamp(1.0f - headroom / soft_headroom, 0.0f, 1.0f);
+}
+
+float EmissionBudget::rateScale(float pressure, float priority) const {
+    // Priority 1 falls off linearly, higher priorities hold their rate longer
+    return std::pow(1.0f - pressure, 1.0f / std::max(priority, 0.01f));
+}
+
+float EmissionBudget::lifetimeScale(float pressure) const {
+    return 1.0f + (min_lifetime_scale - 1.0f) * pressure;
+}
+
+float EmissionBudget::sizeScale(float pressure) const {
+    return 1.0f + (min_size_scale - 1.0f) * pressure;
+}
+
+void EmissionBudget::share(std::span<int> counts, std::span<const float> priorities, size_t available) const {
+    double demand = 0.0;
+    size_t total = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        demand += static_cast<double>(counts[i]) * std::max(priorities[i], 0.01f);
+        total += counts[i];
+    }
+    if (total <= available) return;
+
+    // Each emitter gets a share of the free slots weighted by what it asked
+    // for and its priority, never more than it asked for
+    for (size_t i = 0; i < counts.size(); ++i) {
+        double weight = static_cast<double>(counts[i]) * std::max(priorities[i], 0.01f);
+        int grant = static_cast<int>(available * weight / demand);
+        counts[i] = std::min(counts[i], grant);
+    }
+}
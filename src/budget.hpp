@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <span>
+
+// Degrades emission gracefully as the particle pool fills up. Once free
+// capacity drops below soft_headroom, every emitter's rate is scaled down
+// (less for higher priorities) and new particles can live shorter and
+// shrink. If the particles due still exceed the free slots, they are shared
+// out in proportion to priority instead of first come, first served.
+struct EmissionBudget {
+    bool enabled = false;
+    float soft_headroom = 0.25f;     // Free fraction of the pool where throttling starts
+    float min_lifetime_scale = 1.0f; // Lifetime multiplier at a full pool, 1 keeps it
+    float min_size_scale = 1.0f;     // Size multiplier at a full pool, 1 keeps it
+
+    // How much of the soft headroom is used up, 0 (relaxed) to 1 (pool full)
+    float pressure(size_t free, size_t capacity) const;
+
+    // Rate multiplier for an emitter of the given priority
+    float rateScale(float pressure, float priority) const;
+
+    // Level of detail multipliers for newly spawned particles
+    float lifetimeScale(float pressure) const;
+    float sizeScale(float pressure) const;
+
+    // Trim counts to fit in available slots, weighted by priority
+    void share(std::span<int> counts, std::span<const float> priorities, size_t available) const;
+};
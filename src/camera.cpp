@@ -0,0 +1,49 @@
+#include "camera.hpp"
+#include <algorithm>
+
+Camera::Camera(int viewport_width, int viewport_height)
+    : viewport_width(viewport_width), viewport_height(viewport_height)
+{
+    reset();
+}
+
+void Camera::reset() {
+    x = viewport_width * 0.5f;
+    y = viewport_height * 0.5f;
+    zoom = 1.0f;
+}
+
+void Camera::setZoom(float value) {
+    zoom = std::clamp(value, MIN_ZOOM, MAX_ZOOM);
+}
+
+void Camera::pan(float screen_dx, float screen_dy) {
+    x += screen_dx / zoom;
+    y += screen_dy / zoom;
+}
+
+void Camera::zoomAt(float screen_x, float screen_y, float factor) {
+    float anchor_x, anchor_y;
+    screenToWorld(screen_x, screen_y, anchor_x, anchor_y);
+    setZoom(zoom * factor);
+
+    // Shift so the anchor lands back under the same screen position
+    float moved_x, moved_y;
+    worldToScreen(anchor_x, anchor_y, moved_x, moved_y);
+    pan(moved_x - screen_x, moved_y - screen_y);
+}
+
+void Camera::worldToScreen(float world_x, float world_y, float& screen_x, float& screen_y) const {
+    screen_x = world_x * zoom + getOffsetX();
+    screen_y = world_y * zoom + getOffsetY();
+}
+
+void Camera::screenToWorld(float screen_x, float screen_y, float& world_x, float& world_y) const {
+    world_x = (screen_x - getOffsetX()) / zoom;
+    world_y = (screen_y - getOffsetY()) / zoom;
+}
+
+void Camera::visibleBounds(float& min_x, float& min_y, float& max_x, float& max_y) const {
+    screenToWorld(0.0f, 0.0f, min_x, min_y);
+    screenToWorld(static_cast<float>(viewport_width), static_cast<float>(viewport_height), max_x, max_y);
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+// 2D view onto the world: the world point shown at the center of the
+// viewport and a zoom in screen pixels per world unit. A fresh camera maps
+// world coordinates 1:1 onto the viewport.
+class Camera {
+public:
+    static constexpr float MIN_ZOOM = 0.05f;
+    static constexpr float MAX_ZOOM = 20.0f;
+
+private:
+    float x, y;        // World point at the viewport center
+    float zoom = 1.0f;
+    int viewport_width, viewport_height;
+
+public:
+    Camera(int viewport_width, int viewport_height);
+
+    // Back to the 1:1 view
+    void reset();
+
+    void setPosition(float world_x, float world_y) { x = world_x; y = world_y; }
+    float getX() const { return x; }
+    float getY() const { return y; }
+
+    // Clamped to [MIN_ZOOM, MAX_ZOOM]
+    void setZoom(float value);
+    float getZoom() const { return zoom; }
+
+    // Move the view by a distance in screen pixels
+    void pan(float screen_dx, float screen_dy);
+
+    // Zoom by factor, keeping the world point under a screen position fixed
+    void zoomAt(float screen_x, float screen_y, float factor);
+
+    // screen = world * getZoom() + offset
+    float getOffsetX() const { return viewport_width * 0.5f - x * zoom; }
+    float getOffsetY() const { return viewport_height * 0.5f - y * zoom; }
+
+    void worldToScreen(float world_x, float world_y, float& screen_x, float& screen_y) const;
+    void screenToWorld(float screen_x, float screen_y, float& world_x, float& world_y) const;
+
+    // World rectangle covered by the viewport
+    void visibleBounds(float& min_x, float& min_y, float& max_x, float& max_y) const;
+};
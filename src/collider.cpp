@@ -0,0 +1,189 @@
+#include "collider.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+float SdfGrid::sample(float x, float y) const {
+    float gx = (x - origin_x) / cell_size;
+    float gy = (y - origin_y) / cell_size;
+
+    // Outside the baked area nothing is solid
+    if (gx < 0.0f || gy < 0.0f || gx > width - 1 || gy > height - 1) {
+        return std::numeric_limits<float>::max();
+    }
+
+    int ix = std::min(static_cast<int>(gx), width - 2);
+    int iy = std::min(static_cast<int>(gy), height - 2);
+    float fx = gx - ix;
+    float fy = gy - iy;
+
+    const float* row0 = &distances[static_cast<size_t>(iy) * width + ix];
+    const float* row1 = row0 + width;
+
+    float top = row0[0] + (row0[1] - row0[0]) * fx;
+    float bottom = row1[0] + (row1[1] - row1[0]) * fx;
+    return top + (bottom - top) * fy;
+}
+
+float Collider::signedDistance(float px, float py, float& nx, float& ny) const {
+    switch (type) {
+        case ColliderType::Circle: {
+            float dx = px - x;
+            float dy = py - y;
+            float dist = std::sqrt(dx*dx + dy*dy);
+            if (dist > 0.0001f) {
+                nx = dx / dist;
+                ny = dy / dist;
+            } else {
+                nx = 0.0f;
+                ny = -1.0f;
+            }
+            return dist - radius;
+        }
+
+        case ColliderType::Box: {
+            float dx = px - x;
+            float dy = py - y;
+            float qx = std::fabs(dx) - half_width;
+            float qy = std::fabs(dy) - half_height;
+            float sx = dx < 0.0f ? -1.0f : 1.0f;
+            float sy = dy < 0.0f ? -1.0f : 1.0f;
+
+            if (qx > 0.0f || qy > 0.0f) {
+                // Outside - distance to the nearest edge or corner
+                float ox = std::max(qx, 0.0f);
+                float oy = std::max(qy, 0.0f);
+                float dist = std::sqrt(ox*ox + oy*oy);
+                nx = sx * ox / dist;
+                ny = sy * oy / dist;
+                return dist;
+            }
+
+            // Inside - push out through the closest face
+            if (qx > qy) {
+                nx = sx;
+                ny = 0.0f;
+                return qx;
+            }
+            nx = 0.0f;
+            ny = sy;
+            return qy;
+        }
+
+        case ColliderType::Capsule: {
+            // Closest point on the segment
+            float sx = x2 - x;
+            float sy = y2 - y;
+            float len_sq = sx*sx + sy*sy;
+            float t = len_sq > 0.0f ? ((px - x) * sx + (py - y) * sy) / len_sq : 0.0f;
+            t = std::clamp(t, 0.0f, 1.0f);
+
+            float dx = px - (x + sx * t);
+            float dy = py - (y + sy * t);
+            float dist = std::sqrt(dx*dx + dy*dy);
+            if (dist > 0.0001f) {
+                nx = dx / dist;
+                ny = dy / dist;
+            } else {
+                // On the spine - use the segment's perpendicular
+                float len = std::sqrt(len_sq);
+                nx = len > 0.0f ? -sy / len : 0.0f;
+                ny = len > 0.0f ? sx / len : -1.0f;
+            }
+            return dist - radius;
+        }
+
+        case ColliderType::SDF: {
+            if (!sdf) break;
+
+            float lx = px - x;
+            float ly = py - y;
+            float dist = sdf->sample(lx, ly);
+            if (dist == std::numeric_limits<float>::max()) {
+                nx = 0.0f;
+                ny = -1.0f;
+                return dist;
+            }
+
+            // Normal from central differences of the field
+            float h = sdf->cell_size * 0.5f;
+            float gx = sdf->sample(lx + h, ly) - sdf->sample(lx - h, ly);
+            float gy = sdf->sample(lx, ly + h) - sdf->sample(lx, ly - h);
+            float len = std::sqrt(gx*gx + gy*gy);
+            if (len > 0.0001f && std::isfinite(len)) {
+                nx = gx / len;
+                ny = gy / len;
+            } else {
+                nx = 0.0f;
+                ny = -1.0f;
+            }
+            return dist;
+        }
+    }
+
+    nx = 0.0f;
+    ny = -1.0f;
+    return std::numeric_limits<float>::max();
+}
+
+void Collider::bounds(float& min_x, float& min_y, float& max_x, float& max_y) const {
+    switch (type) {
+        case ColliderType::Circle:
+            min_x = x - radius; max_x = x + radius;
+            min_y = y - radius; max_y = y + radius;
+            return;
+
+        case ColliderType::Box:
+            min_x = x - half_width;  max_x = x + half_width;
+            min_y = y - half_height; max_y = y + half_height;
+            return;
+
+        case ColliderType::Capsule:
+            min_x = std::min(x, x2) - radius; max_x = std::max(x, x2) + radius;
+            min_y = std::min(y, y2) - radius; max_y = std::max(y, y2) + radius;
+            return;
+
+        case ColliderType::SDF:
+            if (sdf) {
+                min_x = x + sdf->origin_x;
+                min_y = y + sdf->origin_y;
+                max_x = min_x + (sdf->width - 1) * sdf->cell_size;
+                max_y = min_y + (sdf->height - 1) * sdf->cell_size;
+                return;
+            }
+            break;
+    }
+
+    min_x = min_y = 0.0f;
+    max_x = max_y = -1.0f;
+}
+
+std::shared_ptr<SdfGrid> bakeSdf(const std::vector<Collider>& shapes,
+                                 float x, float y, float width, float height,
+                                 float cell_size) {
+    auto grid = std::make_shared<SdfGrid>();
+    grid->origin_x = x;
+    grid->origin_y = y;
+    grid->cell_size = cell_size;
+    grid->width = std::max(2, static_cast<int>(std::ceil(width / cell_size)) + 1);
+    grid->height = std::max(2, static_cast<int>(std::ceil(height / cell_size)) + 1);
+    grid->distances.assign(static_cast<size_t>(grid->width) * grid->height,
+                           std::numeric_limits<float>::max());
+
+    // Union of shapes is the minimum distance at every sample
+    for (int gy = 0; gy < grid->height; ++gy) {
+        for (int gx = 0; gx < grid->width; ++gx) {
+            float px = x + gx * cell_size;
+            float py = y + gy * cell_size;
+            float& d = grid->distances[static_cast<size_t>(gy) * grid->width + gx];
+
+            for (const auto& shape : shapes) {
+                if (shape.type == ColliderType::SDF) continue;
+                float nx, ny;
+                d = std::min(d, shape.signedDistance(px, py, nx, ny));
+            }
+        }
+    }
+
+    return grid;
+}
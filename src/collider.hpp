@@ -0,0 +1,50 @@
+#pragma once
+#include <vector>
+#include <memory>
+
+enum class ColliderType {
+    Circle,
+    Box,
+    Capsule,
+    SDF
+};
+
+// Baked signed distance field sampled on a regular grid (negative inside)
+struct SdfGrid {
+    float origin_x = 0.0f, origin_y = 0.0f; // World position of sample (0, 0)
+    float cell_size = 1.0f;                 // Distance between samples
+    int width = 0, height = 0;              // Sample counts
+    std::vector<float> distances;           // Row-major samples
+
+    // Bilinear distance lookup, returns a large value outside the grid
+    float sample(float x, float y) const;
+};
+
+struct Collider {
+    ColliderType type = ColliderType::Circle;
+    float x = 0.0f, y = 0.0f;        // Position (center, capsule start or SDF offset)
+    float x2 = 0.0f, y2 = 0.0f;      // Capsule end point
+    float radius = 0.0f;             // Circle and capsule radius
+    float half_width = 0.0f;         // Box half extents
+    float half_height = 0.0f;
+    float restitution = 0.3f;        // Bounciness of the normal response
+    float friction = 0.1f;           // Fraction of tangential speed removed per contact
+    bool kinematic = false;          // Moves and imparts its velocity to particles
+    bool active = true;              // Whether collider is active
+    std::shared_ptr<const SdfGrid> sdf; // Only used by SDF colliders
+
+    // Velocity derived from movement, maintained by ParticleSystem for kinematic colliders
+    float vx = 0.0f, vy = 0.0f;
+    float prev_x = 0.0f, prev_y = 0.0f;
+
+    // Signed distance from (px, py) to the surface, writes the outward normal
+    float signedDistance(float px, float py, float& nx, float& ny) const;
+
+    // World-space bounding box
+    void bounds(float& min_x, float& min_y, float& max_x, float& max_y) const;
+};
+
+// Bake the union of primitive colliders into a grid covering the given rectangle
+std::shared_ptr<SdfGrid> bakeSdf(const std::vector<Collider>& shapes,
+                                 float x, float y, float width, float height,
+                                 float cell_size);
@@ -0,0 +1,93 @@
+#include "color_lut.hpp"
+#include <algorithm>
+#include <cmath>
+
+// Convert HSV to RGB for colorful effects
+static void HSVtoRGB(float h, float s, float v, uint8_t& r, uint8_t& g, uint8_t& b) {
+    float c = v * s;
+    float x = c * (1 - fabs(fmod(h / 60.0f, 2) - 1));
+    float m = v - c;
+
+    float r_f, g_f, b_f;
+
+    if (h >= 0 && h < 60) {
+        r_f = c, g_f = x, b_f = 0;
+    } else if (h >= 60 && h < 120) {
+        r_f = x, g_f = c, b_f = 0;
+    } else if (h >= 120 && h < 180) {
+        r_f = 0, g_f = c, b_f = x;
+    } else if (h >= 180 && h < 240) {
+        r_f = 0, g_f = x, b_f = c;
+    } else if (h >= 240 && h < 300) {
+        r_f = x, g_f = 0, b_f = c;
+    } else {
+        r_f = c, g_f = 0, b_f = x;
+    }
+
+    r = static_cast<uint8_t>((r_f + m) * 255);
+    g = static_cast<uint8_t>((g_f + m) * 255);
+    b = static_cast<uint8_t>((b_f + m) * 255);
+}
+
+static std::array<uint32_t, HUE_LUT_SIZE> bakeHueLut() {
+    std::array<uint32_t, HUE_LUT_SIZE> lut;
+    for (size_t i = 0; i < HUE_LUT_SIZE; ++i) {
+        uint8_t r, g, b;
+        HSVtoRGB(i * 360.0f / HUE_LUT_SIZE, 1.0f, 1.0f, r, g, b);
+        lut[i] = packRGBA(r, g, b, 255);
+    }
+    return lut;
+}
+
+const std::array<uint32_t, HUE_LUT_SIZE> HUE_LUT = bakeHueLut();
+
+// Piecewise linear value of a curve at t, held constant past either end
+template <typename Stop, typename Fn>
+static void sampleCurve(const std::vector<Stop>& stops, float t, Fn&& fn) {
+    auto next = std::find_if(stops.begin(), stops.end(), [t](const Stop& s) { return s.t > t; });
+    if (next == stops.begin()) {
+        fn(*next, *next, 0.0f);
+    } else if (next == stops.end()) {
+        fn(stops.back(), stops.back(), 0.0f);
+    } else {
+        const Stop& prev = *(next - 1);
+        fn(prev, *next, (t - prev.t) / (next->t - prev.t));
+    }
+}
+
+ParticleStyle bakeStyle(std::span<const ColorStop> colors, std::span<const SizeStop> sizes) {
+    ParticleStyle style;
+    style.color_stops.assign(colors.begin(), colors.end());
+    style.size_stops.assign(sizes.begin(), sizes.end());
+
+    // Stops may be given in any order
+    std::vector<ColorStop> color_curve = style.color_stops;
+    std::vector<SizeStop> size_curve = style.size_stops;
+    std::stable_sort(color_curve.begin(), color_curve.end(),
+                     [](const ColorStop& a, const ColorStop& b) { return a.t < b.t; });
+    std::stable_sort(size_curve.begin(), size_curve.end(),
+                     [](const SizeStop& a, const SizeStop& b) { return a.t < b.t; });
+
+    // Defaults match the original look: fade out, shrink to 70%
+    if (color_curve.empty()) {
+        color_curve = {{0.0f, 255, 255, 255, 255}, {1.0f, 255, 255, 255, 0}};
+    }
+    if (size_curve.empty()) {
+        size_curve = {{0.0f, 1.0f}, {1.0f, 0.7f}};
+    }
+
+    for (size_t i = 0; i < GRADIENT_LUT_SIZE; ++i) {
+        float t = static_cast<float>(i) / (GRADIENT_LUT_SIZE - 1);
+
+        sampleCurve(color_curve, t, [&](const ColorStop& a, const ColorStop& b, float f) {
+            auto mix = [f](uint8_t x, uint8_t y) {
+                return static_cast<uint8_t>(std::lround(x + (y - x) * f));
+            };
+            style.color[i] = packRGBA(mix(a.r, b.r), mix(a.g, b.g), mix(a.b, b.b), mix(a.a, b.a));
+        });
+        sampleCurve(size_curve, t, [&](const SizeStop& a, const SizeStop& b, float f) {
+            style.size[i] = std::max(a.scale + (b.scale - a.scale) * f, 0.0f);
+        });
+    }
+    return style;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Colors are packed as 0xRRGGBBAA
+constexpr uint32_t packRGBA(uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
+    return (uint32_t{r} << 24) | (uint32_t{g} << 16) | (uint32_t{b} << 8) | a;
+}
+
+// Fully saturated rainbow baked once, HUE_LUT_SIZE steps over 360 degrees.
+// A power of two, so hue indices wrap with a mask instead of fmod.
+constexpr size_t HUE_LUT_SIZE = 1024;
+extern const std::array<uint32_t, HUE_LUT_SIZE> HUE_LUT;
+
+// Gradient control points over a particle's life, t = 0 at birth, 1 at death
+struct ColorStop {
+    float t;
+    uint8_t r, g, b, a;
+    bool operator==(const ColorStop&) const = default;
+};
+
+struct SizeStop {
+    float t;
+    float scale;    // Baked as 0 when negative
+    bool operator==(const SizeStop&) const = default;
+};
+
+// Color and size over life baked into lookup tables, indexed by age. Colors
+// multiply a particle's own color, sizes multiply its size.
+constexpr size_t GRADIENT_LUT_SIZE = 64;
+
+struct ParticleStyle {
+    std::array<uint32_t, GRADIENT_LUT_SIZE> color;
+    std::array<float, GRADIENT_LUT_SIZE> size;
+    std::vector<ColorStop> color_stops; // Source curves, to share identical styles
+    std::vector<SizeStop> size_stops;
+};
+
+// Bake gradients; empty curves give the default linear alpha fade and the
+// shrink to 70% size
+ParticleStyle bakeStyle(std::span<const ColorStop> colors, std::span<const SizeStop> sizes);
+
+// Table slot for a particle with life_ratio of its lifetime left
+inline size_t gradientIndex(float life_ratio) {
+    float age = (1.0f - life_ratio) * (GRADIENT_LUT_SIZE - 1) + 0.5f;
+    return age < GRADIENT_LUT_SIZE - 1 ? static_cast<size_t>(age) : GRADIENT_LUT_SIZE - 1;
+}
@@ -0,0 +1,147 @@
+#include "density_renderer.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+// Heat colormap baked once, 256 steps between a few inferno-like stops
+static std::array<uint32_t, 256> bakeHeatMap() {
+    struct Stop { float t, r, g, b; };
+    static constexpr Stop stops[] = {
+        {0.00f,   0,   0,   4},
+        {0.25f,  87,  16, 110},
+        {0.50f, 188,  55,  84},
+        {0.75f, 249, 142,   9},
+        {1.00f, 252, 255, 164},
+    };
+
+    std::array<uint32_t, 256> lut;
+    for (size_t i = 0; i < lut.size(); ++i) {
+        float t = i / 255.0f;
+        size_t k = std::min<size_t>(static_cast<size_t>(t * 4.0f), 3);
+        const Stop& a = stops[k];
+        const Stop& b = stops[k + 1];
+        float f = (t - a.t) / (b.t - a.t);
+        auto mix = [f](float x, float y) { return static_cast<uint32_t>(x + (y - x) * f + 0.5f); };
+        lut[i] = 0xFF000000u | (mix(a.r, b.r) << 16) | (mix(a.g, b.g) << 8) | mix(a.b, b.b);
+    }
+    return lut;
+}
+
+static const std::array<uint32_t, 256> HEAT_MAP = bakeHeatMap();
+
+DensityRenderer::DensityRenderer(SDL_Renderer* renderer, int width, int height)
+    : renderer(renderer), width(width), height(height),
+      pixels(static_cast<size_t>(width) * height, 0)
+{
+    texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING,
+                                width, height);
+    if (texture) {
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_NONE);
+    }
+    setSaturation(64);
+}
+
+DensityRenderer::~DensityRenderer() {
+    if (texture) {
+        SDL_DestroyTexture(texture);
+    }
+}
+
+void DensityRenderer::setSaturation(unsigned int count) {
+    // Log scale, so single particles stay visible next to dense cores
+    count = std::max(count, 1u);
+    levels.resize(count + 1);
+    float scale = 255.0f / std::log1p(static_cast<float>(count));
+    for (unsigned int c = 0; c <= count; ++c) {
+        levels[c] = static_cast<uint8_t>(std::log1p(static_cast<float>(c)) * scale + 0.5f);
+    }
+}
+
+void DensityRenderer::draw(const FrameSnapshot& snapshot, const ParticleStyle* styles, WorkerPool& pool) {
+    if (!texture) return;
+
+    // Scatter groups of segments into private buffers, then resolve by rows
+    size_t segments = snapshot.segment_start.size();
+    unsigned int splat_tasks = static_cast<unsigned int>(
+        std::min<size_t>({segments, MAX_SPLAT_BUFFERS, pool.concurrency()}));
+    if (buffers.size() < splat_tasks) {
+        buffers.resize(splat_tasks, std::vector<Bin>(static_cast<size_t>(width) * height, Bin{}));
+    }
+    pool.run(splat_tasks, [&](unsigned int task, unsigned int task_count) {
+        splatSegments(snapshot, task * segments / task_count, (task + 1) * segments / task_count,
+                      styles, buffers[task]);
+    });
+
+    pool.run(pool.concurrency(), [&](unsigned int task, unsigned int task_count) {
+        resolveRows(static_cast<int>(task * height / task_count),
+                    static_cast<int>((task + 1) * height / task_count), splat_tasks);
+    });
+
+    SDL_UpdateTexture(texture, nullptr, pixels.data(), width * static_cast<int>(sizeof(uint32_t)));
+    SDL_RenderCopy(renderer, texture, nullptr, nullptr);
+}
+
+void DensityRenderer::splatSegments(const FrameSnapshot& snapshot, size_t first, size_t last,
+                                    const ParticleStyle* styles, std::vector<Bin>& buffer) {
+    uint32_t colors[SHADE_BLOCK];
+    float radii[SHADE_BLOCK];
+    for (size_t segment = first; segment < last; ++segment) {
+        const RenderParticle* particles = snapshot.particles.data() + snapshot.segment_start[segment];
+        size_t count = snapshot.segment_count[segment];
+
+        for (size_t block_start = 0; block_start < count; block_start += SHADE_BLOCK) {
+            size_t block = std::min(SHADE_BLOCK, count - block_start);
+            shadeParticles(particles + block_start, block, snapshot.alpha, styles, colors, radii);
+
+            for (size_t i = 0; i < block; ++i) {
+                float px, py;
+                snapshot.project(particles[block_start + i], px, py);
+
+                // Negative coordinates wrap to huge values and fail the bounds test
+                unsigned int x = static_cast<unsigned int>(static_cast<int>(px));
+                unsigned int y = static_cast<unsigned int>(static_cast<int>(py));
+                if (x >= static_cast<unsigned int>(width) || y >= static_cast<unsigned int>(height)) continue;
+
+                Bin& bin = buffer[static_cast<size_t>(y) * width + x];
+                bin.count += 1;
+                bin.r += colors[i] >> 24;
+                bin.g += (colors[i] >> 16) & 0xFF;
+                bin.b += (colors[i] >> 8) & 0xFF;
+            }
+        }
+    }
+}
+
+void DensityRenderer::resolveRows(int y0, int y1, size_t buffer_count) {
+    size_t saturation = levels.size() - 1;
+    size_t begin = static_cast<size_t>(y0) * width;
+    size_t end = static_cast<size_t>(y1) * width;
+    for (size_t i = begin; i < end; ++i) {
+        // Sum the scatter buffers, clearing them for the next frame
+        Bin total{};
+        for (size_t k = 0; k < buffer_count; ++k) {
+            Bin& bin = buffers[k][i];
+            total.count += bin.count;
+            total.r += bin.r;
+            total.g += bin.g;
+            total.b += bin.b;
+            bin = Bin{};
+        }
+
+        if (total.count == 0) {
+            pixels[i] = 0xFF000000u;
+            continue;
+        }
+        uint32_t level = levels[std::min<size_t>(total.count, saturation)];
+        if (coloring == Coloring::Heat) {
+            pixels[i] = HEAT_MAP[level];
+        } else {
+            // Average color, scaled by density level
+            uint64_t scale = static_cast<uint64_t>(total.count) * 255;
+            auto channel = [&](uint32_t sum) {
+                return static_cast<uint32_t>(static_cast<uint64_t>(sum) * level / scale);
+            };
+            pixels[i] = 0xFF000000u | (channel(total.r) << 16) | (channel(total.g) << 8) | channel(total.b);
+        }
+    }
+}
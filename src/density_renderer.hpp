@@ -0,0 +1,62 @@
+#pragma once
+#include "render_backend.hpp"
+#include <SDL2/SDL.h>
+#include <vector>
+
+// Point density view for scenes of millions of sub-pixel particles. Every
+// particle just bumps a per-pixel counter and color sum - no circles, no
+// blending. Snapshot segments are scattered in parallel, each scatter task
+// into its own full-screen buffer, and one resolve pass sums the buffers
+// row by row and maps density through a colormap.
+class DensityRenderer : public RenderBackend {
+public:
+    enum class Coloring {
+        Heat,          // Inferno-like colormap, black through purple and orange to pale yellow
+        ParticleColor  // Average particle color, brightened by density
+    };
+
+    // Each buffer is full screen, so only this many scatter tasks run
+    static constexpr unsigned int MAX_SPLAT_BUFFERS = 4;
+
+private:
+    struct Bin {
+        uint32_t count;
+        uint32_t r, g, b; // Color sums
+    };
+
+    SDL_Renderer* renderer;
+    int width, height;
+    Coloring coloring = Coloring::Heat;
+    SDL_Texture* texture = nullptr;
+    std::vector<std::vector<Bin>> buffers; // One per scatter task, zeroed by resolve
+    std::vector<uint8_t> levels;           // Colormap index by particle count
+    std::vector<uint32_t> pixels;          // Resolved ARGB8888
+
+public:
+    DensityRenderer(SDL_Renderer* renderer, int width, int height);
+    ~DensityRenderer();
+
+    DensityRenderer(const DensityRenderer&) = delete;
+    DensityRenderer& operator=(const DensityRenderer&) = delete;
+
+    const char* getName() const override { return "density"; }
+
+    // False if the texture could not be created (see SDL_GetError)
+    bool isValid() const override { return texture != nullptr; }
+
+    void setColoring(Coloring mode) { coloring = mode; }
+    Coloring getColoring() const { return coloring; }
+
+    // Particles per pixel at the top of the colormap; the scale is
+    // logarithmic below it
+    void setSaturation(unsigned int count);
+    unsigned int getSaturation() const { return static_cast<unsigned int>(levels.size() - 1); }
+
+    // Splat a frame, resolve it and copy it over the render target
+    void draw(const FrameSnapshot& snapshot, const ParticleStyle* styles, WorkerPool& pool) override;
+
+private:
+    void splatSegments(const FrameSnapshot& snapshot, size_t first, size_t last,
+                       const ParticleStyle* styles, std::vector<Bin>& buffer);
+    void resolveRows(int y0, int y1, size_t buffer_count);
+};
@@ -2,39 +2,90 @@
 #include <cmath>
 
 Emitter::Emitter(const EmitterSettings& settings)
-    : settings(settings), rng(std::random_device{}())
+    : Emitter(settings, settings.seed != 0 ? settings.seed
+                                           : (uint64_t{std::random_device{}()} << 32) | std::random_device{}())
 {
 }
 
-int Emitter::update(float dt, std::vector<Particle>& particles) {
+Emitter::Emitter(const EmitterSettings& settings, uint64_t seed)
+    : settings(settings), seed(seed)
+{
+}
+
+int Emitter::prepare(float dt, float rate_scale) {
+    // Bursts fire their whole count exactly once
+    if (settings.burst_count > 0) {
+        int count = burst_fired ? 0 : settings.burst_count;
+        burst_fired = true;
+        return count;
+    }
+    
     time_accumulator += dt;
     
     // Calculate number of particles to emit
-    float particles_to_emit = settings.rate * dt + time_accumulator;
+    float particles_to_emit = settings.rate * rate_scale * dt + time_accumulator;
     int whole_particles = static_cast<int>(particles_to_emit);
     time_accumulator = particles_to_emit - whole_particles;
     
-    int emitted = 0;
-    
-    // Emit particles
-    for (int i = 0; i < whole_particles; ++i) {
-        // Find an inactive particle
-        for (auto& p : particles) {
-            if (!p.active) {
-                emitParticle(p);
-                
-                // Apply any modifiers
-                for (const auto& modifier : modifiers) {
-                    modifier(p);
-                }
-                
-                emitted++;
-                break;
-            }
+    return whole_particles;
+}
+
+void Emitter::emit(std::span<Particle> particles, std::span<const uint32_t> slots) {
+    for (uint32_t slot : slots) {
+        Particle& p = particles[slot];
+        emitParticle(p, spawn_counter++);
+        
+        // Apply any modifiers
+        for (const auto& modifier : modifiers) {
+            modifier(p);
+        }
+        
+        if (settings.type == EmitterType::Spiral) {
+            advanceSpiral();
+        }
+    }
+}
+
+uint64_t Emitter::claimStreams(size_t count) {
+    uint64_t first = spawn_counter;
+    spawn_counter += count;
+    return first;
+}
+
+void Emitter::emitRange(std::span<Particle> particles, std::span<const uint32_t> slots,
+                        uint64_t first_stream) const {
+    for (size_t i = 0; i < slots.size(); ++i) {
+        Particle& p = particles[slots[i]];
+        emitParticle(p, first_stream + i);
+        
+        for (const auto& modifier : modifiers) {
+            modifier(p);
+        }
+    }
+}
+
+void Emitter::emitInherited(std::span<Particle> particles, std::span<const uint32_t> slots,
+                            const SpawnRequest& parent, uint64_t first_stream) const {
+    for (size_t i = 0; i < slots.size(); ++i) {
+        Particle& p = particles[slots[i]];
+        emitParticle(p, first_stream + i);
+        
+        // Emitter shape is laid out around the parent, moving with it
+        p.x += parent.x - settings.x;
+        p.y += parent.y - settings.y;
+        p.prev_x = p.x;
+        p.prev_y = p.y;
+        p.vx += parent.vx;
+        p.vy += parent.vy;
+        p.r = parent.r;
+        p.g = parent.g;
+        p.b = parent.b;
+        p.a = parent.a;
+        
+        for (const auto& modifier : modifiers) {
+            modifier(p);
         }
     }
-    
-    return emitted;
 }
 
 void Emitter::setPosition(float x, float y) {
@@ -46,13 +97,20 @@ void Emitter::addModifier(ParticleModifier modifier) {
     modifiers.push_back(std::move(modifier));
 }
 
-void Emitter::emitParticle(Particle& particle) {
+void Emitter::emitParticle(Particle& particle, uint64_t stream) const {
+    // Every particle draws from its own stream, keyed by spawn order
+    CounterRng rng(seed, stream);
+    
     // Reset particle
     particle.active = true;
-    particle.lifetime = settings.particle_lifetime;
-    particle.max_lifetime = settings.particle_lifetime;
-    particle.size = settings.particle_size;
+    particle.lifetime = settings.particle_lifetime * lifetime_scale;
+    particle.max_lifetime = particle.lifetime;
+    particle.life_ratio = 1.0f;
+    particle.size = settings.particle_size * size_scale;
     particle.colorful_mode = settings.colorful_mode;
+    particle.sub_emitter = static_cast<int16_t>(settings.sub_emitter);
+    particle.style = style;
+    particle.accel_cached = false;
     
     // Random colors
     std::uniform_int_distribution<uint32_t> r_dist(settings.min_r, settings.max_r);
@@ -126,16 +184,42 @@ void Emitter::emitParticle(Particle& particle) {
             // Velocity tangent to spiral
             particle.vx = (-std::sin(angle) * angle_speed + std::cos(angle) * 0.5f) * settings.particle_speed;
             particle.vy = (std::cos(angle) * angle_speed + std::sin(angle) * 0.5f) * settings.particle_speed;
+            break;
+        }
+        
+        case EmitterType::Image: {
+            // Pixel picked in proportion to its weight, jittered within it
+            particle.x = settings.x;
+            particle.y = settings.y;
+            if (settings.mask && !settings.mask->empty()) {
+                const ImageMask& mask = *settings.mask;
+                // Named draws, since argument evaluation order is unspecified
+                uint32_t column_bits = rng();
+                uint32_t threshold_bits = rng();
+                uint32_t pixel = mask.sample(column_bits, threshold_bits);
+                std::uniform_real_distribution<float> jitter_dist(0.0f, 1.0f);
+                float px = static_cast<float>(pixel % mask.getWidth()) + jitter_dist(rng) - 0.5f * mask.getWidth();
+                float py = static_cast<float>(pixel / mask.getWidth()) + jitter_dist(rng) - 0.5f * mask.getHeight();
+                particle.x += px * settings.mask_scale;
+                particle.y += py * settings.mask_scale;
+            }
             
-            // Update spiral parameters
-            settings.spiral_angle += 0.1f;
-            settings.spiral_radius += 0.05f;
-            if (settings.spiral_radius > 100.0f) settings.spiral_radius = 5.0f;
+            // Drift in a random direction
+            std::uniform_real_distribution<float> angle_dist(0.0f, 2.0f * M_PI);
+            float angle = angle_dist(rng);
+            particle.vx = std::cos(angle) * settings.particle_speed;
+            particle.vy = std::sin(angle) * settings.particle_speed;
             break;
         }
     }
     
-    // Initialize acceleration
-    particle.ax = 0.0f;
-    particle.ay = 0.0f;
+    // No motion to interpolate from yet
+    particle.prev_x = particle.x;
+    particle.prev_y = particle.y;
+}
+
+void Emitter::advanceSpiral() {
+    settings.spiral_angle += 0.1f;
+    settings.spiral_radius += 0.05f;
+    if (settings.spiral_radius > 100.0f) settings.spiral_radius = 5.0f;
 }
@@ -1,14 +1,19 @@
 #pragma once
 #include "particle.hpp"
+#include "random.hpp"
+#include "image_mask.hpp"
+#include "color_lut.hpp"
 #include <random>
 #include <vector>
+#include <span>
 #include <functional>
 
 enum class EmitterType {
     Point,
     Circle,
     Line,
-    Spiral
+    Spiral,
+    Image
 };
 
 struct EmitterSettings {
@@ -31,6 +36,41 @@ struct EmitterSettings {
     // Spiral emitter parameters
     float spiral_angle = 0.0f;
     float spiral_radius = 5.0f;
+    
+    // Random stream seed, 0 picks one from std::random_device
+    uint64_t seed = 0;
+    
+    // Burst mode - when > 0, emit exactly this many particles on the next
+    // update and nothing afterwards (rate is ignored). For sub-emitters, the
+    // number of children spawned per dying particle. addBurst() ignores
+    // settings with a count of 0 or less.
+    int burst_count = 0;
+    
+    // Sub-emitter (from ParticleSystem::addSubEmitter) fired when a particle
+    // of this emitter dies, -1 for none
+    int sub_emitter = -1;
+    
+    // Share of the emission budget when the particle pool is nearly full
+    float priority = 1.0f;
+    
+    // Image emitter parameters - spawn density follows the mask's pixel
+    // weights, centered on the emitter position
+    std::shared_ptr<const ImageMask> mask = nullptr;
+    float mask_scale = 1.0f;     // World units per mask pixel
+    
+    // Gradients over particle life, baked into lookup tables when the
+    // emitter is added. Empty keeps the default fade and shrink.
+    std::vector<ColorStop> color_over_life = {};
+    std::vector<SizeStop> size_over_life = {};
+};
+
+// Death of a particle that has a sub-emitter, queued by the update kernel
+// and spawned in the next emission phase
+struct SpawnRequest {
+    float x, y;
+    float vx, vy;
+    uint8_t r, g, b, a;
+    int16_t sub_emitter;
 };
 
 using ParticleModifier = std::function<void(Particle&)>;
@@ -39,18 +79,58 @@ class Emitter {
 private:
     EmitterSettings settings;
     float time_accumulator = 0.0f;
-    std::mt19937 rng;
+    uint64_t seed;               // Base of every spawned particle's random stream
+    uint64_t spawn_counter = 0;  // Stream id of the next particle
+    bool burst_fired = false;    // Burst emitters fire once
+    float lifetime_scale = 1.0f; // Level of detail set by the emission budget
+    float size_scale = 1.0f;
+    uint16_t style = 0;          // Baked gradients in the owning system
     std::vector<ParticleModifier> modifiers;
     
 public:
     Emitter(const EmitterSettings& settings);
+    Emitter(const EmitterSettings& settings, uint64_t seed);
+    
+    // Advance the emission clock at rate_scale times the configured rate,
+    // returns how many particles are due
+    int prepare(float dt, float rate_scale = 1.0f);
+    
+    // Spawn one particle into each of the given slots
+    void emit(std::span<Particle> particles, std::span<const uint32_t> slots);
+    
+    // Split emission for large batches: claimStreams hands out the stream
+    // ids of the next count particles, then emitRange fills any part of the
+    // batch from any thread. The result matches emit() on the whole batch.
+    // Not for emitters with per-particle state (see isSequential).
+    uint64_t claimStreams(size_t count);
+    void emitRange(std::span<Particle> particles, std::span<const uint32_t> slots,
+                   uint64_t first_stream) const;
+    
+    // Spiral emitters advance their angle with every particle, so only
+    // emit() can fill them, in order
+    bool isSequential() const { return settings.type == EmitterType::Spiral; }
+    
+    // Spawn children of a dead particle into the given slots: they start at
+    // its position, add its velocity and take its color. Streams are passed
+    // in rather than counted, so many threads can use one sub-emitter.
+    void emitInherited(std::span<Particle> particles, std::span<const uint32_t> slots,
+                       const SpawnRequest& parent, uint64_t first_stream) const;
+    
+    int getBurstCount() const { return settings.burst_count; }
+    float getPriority() const { return settings.priority; }
+    
+    void setStyle(uint16_t id) { style = id; }
     
-    // Returns number of particles emitted
-    int update(float dt, std::vector<Particle>& particles);
+    // Scale lifetime and size of particles spawned from now on
+    void setLevelOfDetail(float lifetime, float size) {
+        lifetime_scale = lifetime;
+        size_scale = size;
+    }
     
     void setPosition(float x, float y);
     void addModifier(ParticleModifier modifier);
     
 private:
-    void emitParticle(Particle& particle);
+    void emitParticle(Particle& particle, uint64_t stream) const;
+    void advanceSpiral();
 };
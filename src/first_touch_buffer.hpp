@@ -0,0 +1,73 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+// Fixed-size array whose memory is allocated but not touched until each
+// range is constructed. Large allocations come straight from the OS, so
+// on NUMA machines the pages land on the node of whichever thread calls
+// construct() for them first.
+template <typename T>
+class FirstTouchBuffer {
+    static_assert(std::is_trivially_destructible_v<T>, "elements are never destroyed");
+    
+private:
+    static constexpr std::align_val_t ALIGNMENT{64}; // Cache line
+    T* storage = nullptr;
+    size_t count = 0;
+    
+public:
+    FirstTouchBuffer() = default;
+    explicit FirstTouchBuffer(size_t size) { allocate(size); }
+    ~FirstTouchBuffer() { release(); }
+    
+    FirstTouchBuffer(const FirstTouchBuffer&) = delete;
+    FirstTouchBuffer& operator=(const FirstTouchBuffer&) = delete;
+    FirstTouchBuffer(FirstTouchBuffer&& other) noexcept
+        : storage(std::exchange(other.storage, nullptr)), count(std::exchange(other.count, 0)) {}
+    FirstTouchBuffer& operator=(FirstTouchBuffer&& other) noexcept {
+        std::swap(storage, other.storage);
+        std::swap(count, other.count);
+        return *this;
+    }
+    
+    // Reserve uninitialized storage - every element must be constructed
+    // through construct() before use
+    void allocate(size_t size) {
+        release();
+        if (size == 0) return;
+        storage = static_cast<T*>(::operator new(size * sizeof(T), ALIGNMENT));
+        count = size;
+    }
+    
+    // Value-initialize [begin, end), touching those pages from this thread
+    void construct(size_t begin, size_t end) {
+        std::uninitialized_value_construct(storage + begin, storage + end);
+    }
+    
+    T* data() { return storage; }
+    const T* data() const { return storage; }
+    size_t size() const { return count; }
+    
+    T& operator[](size_t i) { return storage[i]; }
+    const T& operator[](size_t i) const { return storage[i]; }
+    
+    T* begin() { return storage; }
+    T* end() { return storage + count; }
+    const T* begin() const { return storage; }
+    const T* end() const { return storage + count; }
+    
+    std::span<T> span() { return {storage, count}; }
+    
+private:
+    void release() {
+        if (storage) {
+            ::operator delete(storage, ALIGNMENT);
+        }
+        storage = nullptr;
+        count = 0;
+    }
+};
@@ -0,0 +1,240 @@
+#include "frame_writer.hpp"
+#include <algorithm>
+#include <cstring>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// BT.601 studio range, the Y4M default, in 8.8 fixed point
+static inline uint8_t lumaOf(int r, int g, int b) {
+    return static_cast<uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+}
+
+static inline uint8_t chromaUOf(int r, int g, int b) {
+    return static_cast<uint8_t>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+}
+
+static inline uint8_t chromaVOf(int r, int g, int b) {
+    return static_cast<uint8_t>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+}
+
+#if defined(__SSE2__)
+// Eight ARGB8888 pixels as 16-bit R, G and B lanes
+static inline void unpackRGB(const uint32_t* pixels, __m128i& r, __m128i& g, __m128i& b) {
+    const __m128i mask = _mm_set1_epi32(0xFF);
+    __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels));
+    __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + 4));
+    r = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(lo, 16), mask), _mm_and_si128(_mm_srli_epi32(hi, 16), mask));
+    g = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(lo, 8), mask), _mm_and_si128(_mm_srli_epi32(hi, 8), mask));
+    b = _mm_packs_epi32(_mm_and_si128(lo, mask), _mm_and_si128(hi, mask));
+}
+
+// Eight luma bytes. The weighted sum fits 16 unsigned bits, so wrapping
+// 16-bit multiplies and a logical shift give the exact scalar result.
+static inline void storeLuma(uint8_t* out, __m128i r, __m128i g, __m128i b) {
+    __m128i sum = _mm_add_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(66)),
+                                _mm_mullo_epi16(g, _mm_set1_epi16(129)));
+    sum = _mm_add_epi16(sum, _mm_mullo_epi16(b, _mm_set1_epi16(25)));
+    sum = _mm_add_epi16(sum, _mm_set1_epi16(128));
+    __m128i y = _mm_add_epi16(_mm_srli_epi16(sum, 8), _mm_set1_epi16(16));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(y, y));
+}
+
+// Average 2x2 blocks: rows summed, then adjacent lanes by madd, rounded
+static inline __m128i average2x2(__m128i top, __m128i bottom) {
+    __m128i pairs = _mm_madd_epi16(_mm_add_epi16(top, bottom), _mm_set1_epi16(1));
+    __m128i mean = _mm_srli_epi32(_mm_add_epi32(pairs, _mm_set1_epi32(2)), 2);
+    return _mm_packs_epi32(mean, mean);
+}
+
+// Four bytes of one chroma plane from averaged R, G, B (signed weights)
+static inline void storeChroma(uint8_t* out, __m128i r, __m128i g, __m128i b, int wr, int wg, int wb) {
+    __m128i sum = _mm_add_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(static_cast<short>(wr))),
+                                _mm_mullo_epi16(g, _mm_set1_epi16(static_cast<short>(wg))));
+    sum = _mm_add_epi16(sum, _mm_mullo_epi16(b, _mm_set1_epi16(static_cast<short>(wb))));
+    sum = _mm_add_epi16(sum, _mm_set1_epi16(128));
+    __m128i c = _mm_add_epi16(_mm_srai_epi16(sum, 8), _mm_set1_epi16(128));
+    int packed = _mm_cvtsi128_si32(_mm_packus_epi16(c, c));
+    std::memcpy(out, &packed, 4);
+}
+#endif
+
+// ARGB8888 to planar 4:2:0. Chroma is the mean of each 2x2 block; an odd
+// last row or column repeats its edge pixels.
+static void convertYuv420(const uint32_t* pixels, int width, int height,
+                          uint8_t* luma, uint8_t* plane_u, uint8_t* plane_v) {
+    int chroma_width = (width + 1) / 2;
+    for (int y = 0; y < height; y += 2) {
+        const uint32_t* row0 = pixels + static_cast<size_t>(y) * width;
+        const uint32_t* row1 = y + 1 < height ? row0 + width : row0;
+        uint8_t* luma0 = luma + static_cast<size_t>(y) * width;
+        uint8_t* luma1 = y + 1 < height ? luma0 + width : nullptr;
+        uint8_t* u = plane_u + static_cast<size_t>(y / 2) * chroma_width;
+        uint8_t* v = plane_v + static_cast<size_t>(y / 2) * chroma_width;
+
+        int x = 0;
+#if defined(__SSE2__)
+        for (; x + 8 <= width; x += 8) {
+            __m128i r0, g0, b0, r1, g1, b1;
+            unpackRGB(row0 + x, r0, g0, b0);
+            unpackRGB(row1 + x, r1, g1, b1);
+            storeLuma(luma0 + x, r0, g0, b0);
+            if (luma1) {
+                storeLuma(luma1 + x, r1, g1, b1);
+            }
+
+            __m128i r = average2x2(r0, r1);
+            __m128i g = average2x2(g0, g1);
+            __m128i b = average2x2(b0, b1);
+            storeChroma(u + x / 2, r, g, b, -38, -74, 112);
+            storeChroma(v + x / 2, r, g, b, 112, -94, -18);
+        }
+#endif
+        for (; x < width; x += 2) {
+            int x1 = std::min(x + 1, width - 1);
+            uint32_t block[4] = {row0[x], row0[x1], row1[x], row1[x1]};
+            int r = 0, g = 0, b = 0;
+            for (uint32_t p : block) {
+                r += (p >> 16) & 0xFF;
+                g += (p >> 8) & 0xFF;
+                b += p & 0xFF;
+            }
+            r = (r + 2) >> 2;
+            g = (g + 2) >> 2;
+            b = (b + 2) >> 2;
+            u[x / 2] = chromaUOf(r, g, b);
+            v[x / 2] = chromaVOf(r, g, b);
+
+            for (int i = x; i <= x1; ++i) {
+                luma0[i] = lumaOf((row0[i] >> 16) & 0xFF, (row0[i] >> 8) & 0xFF, row0[i] & 0xFF);
+                if (luma1) {
+                    luma1[i] = lumaOf((row1[i] >> 16) & 0xFF, (row1[i] >> 8) & 0xFF, row1[i] & 0xFF);
+                }
+            }
+        }
+    }
+}
+
+FrameWriter::FrameWriter(const std::string& path, Format format, int width, int height, int fps)
+    : format(format), width(width), height(height), path(path)
+{
+    size_t frame_pixels = static_cast<size_t>(width) * height;
+    for (Slot& slot : slots) {
+        slot.pixels.resize(frame_pixels);
+    }
+
+    if (format == Format::Y4M) {
+        if (path == "-") {
+            stream = stdout;
+        } else {
+            stream = std::fopen(path.c_str(), "wb");
+            owns_stream = stream != nullptr;
+        }
+        if (!stream) return;
+
+        size_t chroma = static_cast<size_t>((width + 1) / 2) * ((height + 1) / 2);
+        converted.resize(frame_pixels + 2 * chroma);
+        if (std::fprintf(stream, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width, height, fps) < 0) {
+            failed.store(true);
+        }
+    } else {
+        converted.resize(frame_pixels * 3);
+    }
+
+    writer = std::jthread([this]() { writerLoop(); });
+}
+
+FrameWriter::~FrameWriter() {
+    close();
+}
+
+uint32_t* FrameWriter::nextFrame() {
+    Slot& slot = slots[submit_slot];
+    slot.full.wait(true);
+    return slot.pixels.data();
+}
+
+void FrameWriter::submit() {
+    Slot& slot = slots[submit_slot];
+    slot.full.store(true);
+    slot.full.notify_one();
+    submit_slot ^= 1;
+}
+
+void FrameWriter::close() {
+    if (!writer.joinable()) return;
+
+    // Once both slots are drained the writer is parked on the next one, and
+    // a full slot with closing set tells it to exit
+    slots[submit_slot ^ 1].full.wait(true);
+    Slot& slot = slots[submit_slot];
+    slot.full.wait(true);
+    closing = true;
+    slot.full.store(true);
+    slot.full.notify_one();
+    writer.join();
+
+    if (stream && std::fflush(stream) != 0) {
+        failed.store(true);
+    }
+    if (owns_stream) {
+        std::fclose(stream);
+    }
+    stream = nullptr;
+    owns_stream = false;
+}
+
+void FrameWriter::writerLoop() {
+    size_t current = 0;
+    while (true) {
+        Slot& slot = slots[current];
+        slot.full.wait(false);
+        if (closing) return;
+
+        if (format == Format::Y4M) {
+            writeY4M(slot.pixels.data());
+        } else {
+            writePPM(slot.pixels.data());
+        }
+        ++frame_index;
+
+        slot.full.store(false);
+        slot.full.notify_one();
+        current ^= 1;
+    }
+}
+
+void FrameWriter::writeY4M(const uint32_t* pixels) {
+    size_t luma_size = static_cast<size_t>(width) * height;
+    size_t chroma_size = (converted.size() - luma_size) / 2;
+    uint8_t* luma = converted.data();
+    convertYuv420(pixels, width, height, luma, luma + luma_size, luma + luma_size + chroma_size);
+
+    if (std::fputs("FRAME\n", stream) < 0 ||
+        std::fwrite(converted.data(), 1, converted.size(), stream) != converted.size()) {
+        failed.store(true);
+    }
+}
+
+void FrameWriter::writePPM(const uint32_t* pixels) {
+    size_t count = static_cast<size_t>(width) * height;
+    for (size_t i = 0; i < count; ++i) {
+        converted[i * 3 + 0] = static_cast<uint8_t>(pixels[i] >> 16);
+        converted[i * 3 + 1] = static_cast<uint8_t>(pixels[i] >> 8);
+        converted[i * 3 + 2] = static_cast<uint8_t>(pixels[i]);
+    }
+
+    char name[32];
+    std::snprintf(name, sizeof(name), "_%06llu.ppm", static_cast<unsigned long long>(frame_index));
+    FILE* file = std::fopen((path + name).c_str(), "wb");
+    if (!file) {
+        failed.store(true);
+        return;
+    }
+    bool ok = std::fprintf(file, "P6\n%d %d\n255\n", width, height) > 0 &&
+              std::fwrite(converted.data(), 1, converted.size(), file) == converted.size();
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        failed.store(true);
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Streams rendered frames to disk, or to stdout for piping into an encoder,
+// as raw Y4M (4:2:0, converted from RGB with SIMD) or as numbered PPM files.
+// Frames are handed to a writer thread through two buffers: the render
+// thread fills one while the other is converted and written, so I/O only
+// holds up rendering when the writer falls a whole frame behind. No frame
+// is ever dropped.
+class FrameWriter {
+public:
+    enum class Format {
+        Y4M,  // One stream; path "-" writes to stdout
+        PPM   // One file per frame, path is a prefix: <path>_000000.ppm
+    };
+
+private:
+    struct Slot {
+        std::vector<uint32_t> pixels;     // ARGB8888, tightly packed
+        std::atomic<bool> full{false};    // Owned by the writer while set
+    };
+
+    Format format;
+    int width, height;
+    std::string path;
+    FILE* stream = nullptr;               // Y4M output
+    bool owns_stream = false;
+    Slot slots[2];
+    size_t submit_slot = 0;               // Next slot the render thread fills
+    bool closing = false;                 // Set before the final hand-off
+    uint64_t frame_index = 0;             // Frames written, for PPM names
+    std::atomic<bool> failed{false};
+    std::vector<uint8_t> converted;       // Writer-side YUV or RGB frame
+    std::jthread writer;
+
+public:
+    // fps is only recorded in the Y4M header
+    FrameWriter(const std::string& path, Format format, int width, int height, int fps = 60);
+    ~FrameWriter();
+
+    FrameWriter(const FrameWriter&) = delete;
+    FrameWriter& operator=(const FrameWriter&) = delete;
+
+    // False if the output could not be opened
+    bool isOpen() const { return format == Format::PPM || stream != nullptr; }
+
+    // True once any write has failed (disk full, closed pipe...)
+    bool hasFailed() const { return failed.load(); }
+
+    // Buffer for the next frame, width * height ARGB8888 pixels. Waits if
+    // the writer still holds it from two frames ago.
+    uint32_t* nextFrame();
+
+    // Hand the frame filled through nextFrame() to the writer
+    void submit();
+
+    // Write out everything submitted and stop the writer thread
+    void close();
+
+private:
+    void writerLoop();
+    void writeY4M(const uint32_t* pixels);
+    void writePPM(const uint32_t* pixels);
+};
@@ -0,0 +1,21 @@
+#include "geometry_renderer.hpp"
+#include <algorithm>
+
+void GeometryRenderer::draw(const FrameSnapshot& view, const ParticleStyle* styles, WorkerPool&) {
+    // Shade a block of particles at a time, then queue their quads
+    uint32_t colors[SHADE_BLOCK];
+    float radii[SHADE_BLOCK];
+    view.forEachSegment([&](const RenderParticle* segment, size_t count) {
+        for (size_t first = 0; first < count; first += SHADE_BLOCK) {
+            size_t block = std::min(SHADE_BLOCK, count - first);
+            shadeParticles(segment + first, block, view.alpha, styles, colors, radii);
+            for (size_t i = 0; i < block; ++i) {
+                float px, py;
+                view.project(segment[first + i], px, py);
+                atlas.add(px, py, radii[i] * view.view_scale, colors[i]);
+            }
+        }
+    });
+
+    atlas.flush(renderer);
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include "render_backend.hpp"
+#include "sprite_atlas.hpp"
+#include <SDL2/SDL.h>
+
+// Every particle one textured quad from the sprite atlas, the whole frame
+// submitted in a single SDL_RenderGeometry call
+class GeometryRenderer : public RenderBackend {
+private:
+    SDL_Renderer* renderer;
+    SpriteAtlas atlas;
+
+public:
+    explicit GeometryRenderer(SDL_Renderer* renderer) : renderer(renderer), atlas(renderer) {}
+
+    const char* getName() const override { return "geometry"; }
+
+    // False if the atlas texture could not be created (see SDL_GetError)
+    bool isValid() const override { return atlas.isValid(); }
+
+    void draw(const FrameSnapshot& view, const ParticleStyle* styles, WorkerPool& pool) override;
+};
@@ -0,0 +1,171 @@
+#include "hdr_renderer.hpp"
+#include <algorithm>
+#include <cmath>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Light below this after a 1/60 s decay is dropped, so trails fade out
+// completely and never linger as denormals
+static constexpr float TRAIL_FLOOR = 1e-4f;
+static constexpr float TRAIL_RATE = 60.0f; // Decay steps per second
+
+// data[i] = max(data[i] * factor - cutoff, 0), four floats at a time
+static void decayLight(float* data, size_t count, float factor, float cutoff) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128 scale = _mm_set1_ps(factor);
+    const __m128 floor = _mm_set1_ps(cutoff);
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4) {
+        __m128 v = _mm_mul_ps(_mm_loadu_ps(data + i), scale);
+        _mm_storeu_ps(data + i, _mm_max_ps(_mm_sub_ps(v, floor), zero));
+    }
+#endif
+    for (; i < count; ++i) {
+        data[i] = std::max(data[i] * factor - cutoff, 0.0f);
+    }
+}
+
+HdrRenderer::HdrRenderer(SDL_Renderer* renderer, int width, int height)
+    : renderer(renderer), width(width), height(height),
+      accumulation(static_cast<size_t>(width) * height * 3, 0.0f),
+      pixels(static_cast<size_t>(width) * height, 0)
+{
+    texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING,
+                                width, height);
+    if (texture) {
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_ADD);
+    }
+}
+
+HdrRenderer::~HdrRenderer() {
+    if (texture) {
+        SDL_DestroyTexture(texture);
+    }
+}
+
+void HdrRenderer::draw(const FrameSnapshot& snapshot, const ParticleStyle* styles, WorkerPool& pool) {
+    if (!texture) return;
+
+    // Decay by the frame's share of 1/60 s steps
+    float steps = std::max(frame_time, 0.0f) * TRAIL_RATE;
+    frame_decay = trail_decay > 0.0f ? std::pow(trail_decay, steps) : 0.0f;
+    frame_floor = TRAIL_FLOOR * steps;
+
+    // Shade and bin each snapshot segment, then light up and resolve each tile
+    lights.resize(snapshot.particles.size());
+    unsigned int segments = static_cast<unsigned int>(snapshot.segment_start.size());
+    bins.resize(width, height, segments);
+    pool.run(segments, [&](unsigned int task, unsigned int) {
+        shadeSegment(snapshot, task, styles);
+    });
+
+    pool.run(static_cast<unsigned int>(bins.getTileCount()), [&](unsigned int tile, unsigned int) {
+        accumulateTile(static_cast<int>(tile));
+        resolveTile(static_cast<int>(tile));
+    });
+
+    SDL_UpdateTexture(texture, nullptr, pixels.data(), width * static_cast<int>(sizeof(uint32_t)));
+    SDL_RenderCopy(renderer, texture, nullptr, nullptr);
+}
+
+void HdrRenderer::shadeSegment(const FrameSnapshot& snapshot, size_t segment, const ParticleStyle* styles) {
+    size_t start = snapshot.segment_start[segment];
+    const RenderParticle* particles = snapshot.particles.data() + start;
+    Light* out = lights.data() + start;
+    size_t count = snapshot.segment_count[segment];
+    bins.clear(segment);
+
+    uint32_t colors[SHADE_BLOCK];
+    float radii[SHADE_BLOCK];
+    for (size_t first = 0; first < count; first += SHADE_BLOCK) {
+        size_t block = std::min(SHADE_BLOCK, count - first);
+        shadeParticles(particles + first, block, snapshot.alpha, styles, colors, radii);
+
+        for (size_t i = 0; i < block; ++i) {
+            Light& light = out[first + i];
+            snapshot.project(particles[first + i], light.x, light.y);
+            light.radius = radii[i] * snapshot.view_scale;
+
+            float weight = (colors[i] & 0xFF) / (255.0f * 255.0f);
+            light.r = (colors[i] >> 24) * weight;
+            light.g = ((colors[i] >> 16) & 0xFF) * weight;
+            light.b = ((colors[i] >> 8) & 0xFF) * weight;
+
+            // Same footprint as the drawn circle: 2r+1 pixels around (x, y)
+            int r = static_cast<int>(light.radius);
+            int cx = static_cast<int>(light.x);
+            int cy = static_cast<int>(light.y);
+            bins.add(segment, static_cast<uint32_t>(start + first + i), cx - r, cy - r, cx + r, cy + r);
+        }
+    }
+}
+
+void HdrRenderer::accumulateTile(int tile) {
+    int tile_x0, tile_y0, tile_x1, tile_y1;
+    bins.tileRect(tile, tile_x0, tile_y0, tile_x1, tile_y1);
+
+    // Fresh or decayed light from the last frame
+    for (int y = tile_y0; y < tile_y1; ++y) {
+        float* row = accumulation.data() + (static_cast<size_t>(y) * width + tile_x0) * 3;
+        size_t floats = static_cast<size_t>(tile_x1 - tile_x0) * 3;
+        if (trail_decay > 0.0f) {
+            decayLight(row, floats, frame_decay, frame_floor);
+        } else {
+            std::fill(row, row + floats, 0.0f);
+        }
+    }
+
+    bins.forEach(tile, [&](uint32_t index) {
+        const Light& light = lights[index];
+        int r = static_cast<int>(light.radius);
+        int cx = static_cast<int>(light.x);
+        int cy = static_cast<int>(light.y);
+
+        // Single pixel particles skip shape rasterization entirely
+        if (r == 0) {
+            float* px = accumulation.data() + (static_cast<size_t>(cy) * width + cx) * 3;
+            px[0] += light.r;
+            px[1] += light.g;
+            px[2] += light.b;
+            return;
+        }
+
+        int y0 = std::max(cy - r, tile_y0);
+        int y1 = std::min(cy + r, tile_y1 - 1);
+        int x0 = std::max(cx - r, tile_x0);
+        int x1 = std::min(cx + r, tile_x1 - 1);
+        float edge = r + 0.5f;
+        for (int y = y0; y <= y1; ++y) {
+            float dy = static_cast<float>(y - cy);
+            float* px = accumulation.data() + (static_cast<size_t>(y) * width + x0) * 3;
+            for (int x = x0; x <= x1; ++x, px += 3) {
+                // Coverage falls off over one pixel at the edge
+                float dx = static_cast<float>(x - cx);
+                float coverage = std::clamp(edge - std::sqrt(dx*dx + dy*dy), 0.0f, 1.0f);
+                px[0] += light.r * coverage;
+                px[1] += light.g * coverage;
+                px[2] += light.b * coverage;
+            }
+        }
+    });
+}
+
+void HdrRenderer::resolveTile(int tile) {
+    int x0, y0, x1, y1;
+    bins.tileRect(tile, x0, y0, x1, y1);
+
+    // Reinhard tone mapping: bright overlaps saturate smoothly toward white
+    auto map = [this](float c) {
+        float v = c * exposure;
+        return static_cast<uint32_t>(255.0f * v / (1.0f + v));
+    };
+    for (int y = y0; y < y1; ++y) {
+        for (int x = x0; x < x1; ++x) {
+            size_t i = static_cast<size_t>(y) * width + x;
+            const float* c = &accumulation[i * 3];
+            pixels[i] = 0xFF000000u | (map(c[0]) << 16) | (map(c[1]) << 8) | map(c[2]);
+        }
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include "render_backend.hpp"
+#include "tile_binner.hpp"
+#include <SDL2/SDL.h>
+#include <vector>
+
+// Additive light accumulation for dense glowing effects. Every particle
+// adds its color, weighted by alpha and coverage, into a float RGB buffer,
+// and a tone-mapped 8-bit image is resolved once per frame and added onto
+// the screen. Particles are shaded and binned into screen tiles one
+// snapshot segment per task, then each tile is lit and resolved by one
+// task, so no two tasks ever write the same pixel.
+//
+// In trail mode the buffer is not cleared between frames but decayed, so
+// moving particles leave streaks even when drawn as single pixels. The
+// decay is scaled by the frame time, so trails are as long at any frame rate.
+class HdrRenderer : public RenderBackend {
+private:
+    // Shaded particle, color premultiplied by alpha and scaled to [0, 1]
+    struct Light {
+        float x, y;
+        float radius;
+        float r, g, b;
+    };
+
+    SDL_Renderer* renderer;
+    int width, height;
+    float exposure = 1.5f;
+    float trail_decay = 0.0f;        // Light kept per 1/60 s
+    float frame_time = 1.0f / 60.0f; // Seconds since the previous frame
+    float frame_decay = 0.0f;        // trail_decay applied over frame_time
+    float frame_floor = 0.0f;        // Light dropped after decay this frame
+    SDL_Texture* texture = nullptr;
+    std::vector<float> accumulation; // RGB per pixel
+    std::vector<uint32_t> pixels;    // Resolved ARGB8888
+    std::vector<Light> lights;       // Indexed like the snapshot's particles
+    TileBinner bins;
+
+public:
+    HdrRenderer(SDL_Renderer* renderer, int width, int height);
+    ~HdrRenderer();
+
+    HdrRenderer(const HdrRenderer&) = delete;
+    HdrRenderer& operator=(const HdrRenderer&) = delete;
+
+    const char* getName() const override { return "hdr"; }
+
+    // False if the texture could not be created (see SDL_GetError)
+    bool isValid() const override { return texture != nullptr; }
+
+    // Scale applied to accumulated light before tone mapping
+    void setExposure(float value) { exposure = value; }
+    float getExposure() const { return exposure; }
+
+    // Fraction of light kept per 1/60 s of frame time, 0 clears (no trails)
+    void setTrailDecay(float factor) { trail_decay = factor; }
+    float getTrailDecay() const { return trail_decay; }
+
+    // Time the next draw advances the trails by, normally the frame's dt
+    void setFrameTime(float seconds) { frame_time = seconds; }
+
+    // Accumulate a frame, resolve it and add it onto the render target
+    void draw(const FrameSnapshot& snapshot, const ParticleStyle* styles, WorkerPool& pool) override;
+
+private:
+    void shadeSegment(const FrameSnapshot& snapshot, size_t segment, const ParticleStyle* styles);
+    void accumulateTile(int tile);
+    void resolveTile(int tile);
+};
@@ -0,0 +1,28 @@
+#include "image_mask.hpp"
+#include <SDL2/SDL.h>
+
+std::shared_ptr<const ImageMask> loadImageMask(const char* path) {
+    SDL_Surface* loaded = SDL_LoadBMP(path);
+    if (!loaded) return nullptr;
+
+    // Read every format through one known byte order
+    SDL_Surface* surface = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(loaded);
+    if (!surface) return nullptr;
+
+    std::vector<float> weights(static_cast<size_t>(surface->w) * surface->h);
+    SDL_LockSurface(surface);
+    for (int y = 0; y < surface->h; ++y) {
+        const uint8_t* row = static_cast<const uint8_t*>(surface->pixels) + y * surface->pitch;
+        for (int x = 0; x < surface->w; ++x) {
+            const uint8_t* px = row + x * 4;
+            float luminance = 0.2126f * px[0] + 0.7152f * px[1] + 0.0722f * px[2];
+            weights[static_cast<size_t>(y) * surface->w + x] = luminance * px[3];
+        }
+    }
+    SDL_UnlockSurface(surface);
+
+    auto mask = std::make_shared<const ImageMask>(surface->w, surface->h, weights);
+    SDL_FreeSurface(surface);
+    return mask;
+}
@@ -0,0 +1,43 @@
+#include "image_mask.hpp"
+
+ImageMask::ImageMask(int width, int height, std::span<const float> weights)
+    : width(width), height(height)
+{
+    size_t n = weights.size();
+    double total = 0.0;
+    for (float w : weights) {
+        total += w > 0.0f ? w : 0.0f;
+    }
+    if (n == 0 || total <= 0.0) return;
+
+    // Vose's method: scale weights so the mean is 1, then pair each
+    // under-full column with an over-full one that tops it up
+    std::vector<double> scaled(n);
+    std::vector<uint32_t> small, large;
+    for (size_t i = 0; i < n; ++i) {
+        scaled[i] = (weights[i] > 0.0f ? weights[i] : 0.0f) * n / total;
+        (scaled[i] < 1.0 ? small : large).push_back(static_cast<uint32_t>(i));
+    }
+
+    table.resize(n);
+    while (!small.empty() && !large.empty()) {
+        uint32_t s = small.back();
+        small.pop_back();
+        uint32_t l = large.back();
+
+        table[s] = {static_cast<float>(scaled[s]), l};
+        scaled[l] -= 1.0 - scaled[s];
+        if (scaled[l] < 1.0) {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+
+    // Leftovers are full columns, up to rounding error
+    for (uint32_t i : large) {
+        table[i] = {1.0f, i};
+    }
+    for (uint32_t i : small) {
+        table[i] = {1.0f, i};
+    }
+}
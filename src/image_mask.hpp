@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+// Spawn distribution over the pixels of an image, with density proportional
+// to pixel weight. Sampling is O(1) through a Vose alias table, so large
+// bursts cost the same per particle whatever the image size.
+class ImageMask {
+private:
+    // Pick the column's own pixel below threshold, otherwise its alias
+    struct AliasEntry {
+        float threshold;
+        uint32_t alias;
+    };
+
+    int width = 0, height = 0;
+    std::vector<AliasEntry> table; // Empty when every weight is zero
+
+public:
+    // Weights are row-major, one per pixel, and need not be normalized
+    ImageMask(int width, int height, std::span<const float> weights);
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    bool empty() const { return table.empty(); }
+
+    // Pixel index drawn from two uniform 32-bit random numbers
+    uint32_t sample(uint32_t column_bits, uint32_t threshold_bits) const {
+        uint32_t column = static_cast<uint32_t>((uint64_t{column_bits} * table.size()) >> 32);
+        const AliasEntry& entry = table[column];
+        return threshold_bits * 0x1p-32f < entry.threshold ? column : entry.alias;
+    }
+};
+
+// Load a BMP and weight each pixel by luminance times alpha, so both
+// grayscale and alpha masks work. Returns nullptr if loading fails.
+// Defined in image_loader.cpp, the only part that needs SDL.
+std::shared_ptr<const ImageMask> loadImageMask(const char* path);
@@ -0,0 +1,71 @@
+#pragma once
+#include "particle.hpp"
+
+enum class IntegratorType {
+    SymplecticEuler,
+    VelocityVerlet,
+    MidpointRK2
+};
+
+// Integrator policies advance one particle by dt. (ax, ay) is the
+// acceleration at the particle's current position; `accel(x, y, ax, ay)`
+// evaluates the acceleration at any other position. Policies with
+// CACHES_ACCELERATION leave the end-of-step acceleration in p.ax, p.ay,
+// and the kernel reuses it as the next step's starting acceleration.
+
+// Semi-implicit Euler - one force evaluation, velocity first
+struct SymplecticEuler {
+    static constexpr bool CACHES_ACCELERATION = false;
+    
+    template <typename AccelFn>
+    static void integrate(Particle& p, float ax, float ay, float dt, AccelFn&&) {
+        p.vx += ax * dt;
+        p.vy += ay * dt;
+        p.x += p.vx * dt;
+        p.y += p.vy * dt;
+    }
+};
+
+// Velocity Verlet - averages the acceleration at both ends of the step. The
+// end-of-step acceleration is kept for the next step, so in steady state
+// this costs one force evaluation per step, like Euler. Neighbor forces at
+// the end of the step still come from the start-of-step spatial grid, so
+// the particle-interaction repulsion is not time-symmetric.
+struct VelocityVerlet {
+    static constexpr bool CACHES_ACCELERATION = true;
+    
+    template <typename AccelFn>
+    static void integrate(Particle& p, float ax, float ay, float dt, AccelFn&& accel) {
+        p.x += (p.vx + 0.5f * ax * dt) * dt;
+        p.y += (p.vy + 0.5f * ay * dt) * dt;
+
+        float ax1, ay1;
+        accel(p.x, p.y, ax1, ay1);
+
+        p.vx += 0.5f * (ax + ax1) * dt;
+        p.vy += 0.5f * (ay + ay1) * dt;
+        p.ax = ax1;
+        p.ay = ay1;
+        p.accel_cached = true;
+    }
+};
+
+// Midpoint RK2 - steps with the derivative sampled half way along
+struct MidpointRK2 {
+    static constexpr bool CACHES_ACCELERATION = false;
+    
+    template <typename AccelFn>
+    static void integrate(Particle& p, float ax, float ay, float dt, AccelFn&& accel) {
+        float half_dt = 0.5f * dt;
+        float mid_vx = p.vx + ax * half_dt;
+        float mid_vy = p.vy + ay * half_dt;
+
+        float mid_ax, mid_ay;
+        accel(p.x + p.vx * half_dt, p.y + p.vy * half_dt, mid_ax, mid_ay);
+
+        p.x += mid_vx * dt;
+        p.y += mid_vy * dt;
+        p.vx += mid_ax * dt;
+        p.vy += mid_ay * dt;
+    }
+};
@@ -1,16 +1,27 @@
 #include "system.hpp"
+#include "point_renderer.hpp"
+#include "geometry_renderer.hpp"
+#include "hdr_renderer.hpp"
+#include "software_renderer.hpp"
+#include "density_renderer.hpp"
+#include "frame_writer.hpp"
 #include <SDL2/SDL.h>
 #include <iostream>
 #include <chrono>
 #include <thread>
 #include <vector>
 #include <string>
+#include <charconv>
+#include <csignal>
+#include <cstring>
 
 // Function declaration
 void drawCircle(SDL_Renderer* renderer, int x, int y, int radius);
 
 const int SCREEN_WIDTH = 1280;
 const int SCREEN_HEIGHT = 720;
+const float PAN_STEP = 40.0f;  // Screen pixels per arrow key press
+const int CAPTURE_FPS = 60;    // Simulated frame rate of captured output
 
 int main(int argc, char* argv[]) {
     // Initialize SDL
@@ -44,8 +55,134 @@ int main(int argc, char* argv[]) {
     // Enable alpha blending
     SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
     
+    // Render backends, picked per frame from the toggles below
+    auto point_renderer = std::make_unique<PointRenderer>(renderer);
+    NullRenderer null_renderer;
+    bool use_null = false;
+    
+    // Prerasterized circles, one textured quad per particle
+    auto geometry_renderer = std::make_unique<GeometryRenderer>(renderer);
+    if (!geometry_renderer->isValid()) {
+        std::cerr << "Sprite atlas could not be created! SDL_Error: " << SDL_GetError() << std::endl;
+    }
+    bool use_sprites = geometry_renderer->isValid();
+    
+    // Additive glow mode, accumulated on the worker threads
+    auto hdr_renderer = std::make_unique<HdrRenderer>(renderer, SCREEN_WIDTH, SCREEN_HEIGHT);
+    if (!hdr_renderer->isValid()) {
+        std::cerr << "HDR buffer could not be created! SDL_Error: " << SDL_GetError() << std::endl;
+    }
+    bool use_hdr = false;
+    
+    // Tile-binned CPU rasterizer running on the worker threads
+    auto software_renderer = std::make_unique<SoftwareRenderer>(renderer, SCREEN_WIDTH, SCREEN_HEIGHT);
+    if (!software_renderer->isValid()) {
+        std::cerr << "Software renderer could not be created! SDL_Error: " << SDL_GetError() << std::endl;
+    }
+    bool use_software = false;
+    
+    // Point density splatting for very large particle counts
+    auto density_renderer = std::make_unique<DensityRenderer>(renderer, SCREEN_WIDTH, SCREEN_HEIGHT);
+    if (!density_renderer->isValid()) {
+        std::cerr << "Density renderer could not be created! SDL_Error: " << SDL_GetError() << std::endl;
+    }
+    bool use_density = false;
+    bool trails = false;
+    
+    // Command line options
+    bool deterministic = false;
+    uint64_t seed = 0;
+    bool pin_threads = false;
+    bool render_stats = false;
+    std::unique_ptr<FrameWriter> capture;
+    long capture_frames = 0;  // Quit after this many captured frames, 0 runs on
+    std::shared_ptr<const ImageMask> mask;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--seed" && i + 1 < argc) {
+            // Reproducible emission for a given seed
+            const char* text = argv[++i];
+            const char* text_end = text + std::strlen(text);
+            auto [end, error] = std::from_chars(text, text_end, seed);
+            if (error != std::errc() || end != text_end) {
+                std::cerr << "Invalid seed " << text << ", ignoring --seed" << std::endl;
+                seed = 0;
+            } else {
+                deterministic = true;
+            }
+        } else if (arg == "--pin-threads") {
+            // Pin workers to cores and keep particle memory on their NUMA node
+            pin_threads = true;
+        } else if (arg == "--render-stats") {
+            // Print the active backend's average render time
+            render_stats = true;
+        } else if ((arg == "--capture" || arg == "--capture-ppm") && i + 1 < argc) {
+            // Record every frame as a Y4M stream ("-" for stdout) or numbered PPMs
+            std::string target = argv[++i];
+            auto format = arg == "--capture" ? FrameWriter::Format::Y4M : FrameWriter::Format::PPM;
+            capture = std::make_unique<FrameWriter>(target, format, SCREEN_WIDTH, SCREEN_HEIGHT, CAPTURE_FPS);
+            if (!capture->isOpen()) {
+                std::cerr << "Could not open capture output " << target << std::endl;
+                capture.reset();
+            } else if (format == FrameWriter::Format::Y4M && target == "-") {
+                // Keep console messages out of the video stream
+                std::cout.rdbuf(std::cerr.rdbuf());
+#ifdef SIGPIPE
+                // Let a closed pipe fail the write instead of killing us
+                std::signal(SIGPIPE, SIG_IGN);
+#endif
+            }
+        } else if (arg == "--frames" && i + 1 < argc) {
+            const char* text = argv[++i];
+            const char* text_end = text + std::strlen(text);
+            auto [end, error] = std::from_chars(text, text_end, capture_frames);
+            if (error != std::errc() || end != text_end || capture_frames < 0) {
+                std::cerr << "Invalid frame count " << text << ", ignoring --frames" << std::endl;
+                capture_frames = 0;
+            }
+        } else if (arg == "--mask" && i + 1 < argc) {
+            // Image for the mask burst (M key)
+            mask = loadImageMask(argv[++i]);
+            if (!mask) {
+                std::cerr << "Could not load mask image! SDL_Error: " << SDL_GetError() << std::endl;
+            }
+        }
+    }
+    
     // Create particle system
-    ParticleSystem system(50000, 4); // 50k particles, 4 threads
+    auto worker_pool = std::make_shared<WorkerPool>(4, pin_threads); // 4 threads
+    if (pin_threads && !worker_pool->isPinned()) {
+        std::cerr << "Worker threads could not be pinned, running unpinned" << std::endl;
+    }
+    ParticleSystem system(50000, worker_pool); // 50k particles
+    system.setDeterministic(deterministic, seed);
+    
+    // Only wake as many workers as the live particle count needs
+    system.setAdaptiveWorkers(true);
+    
+    // Near a full pool, throttle emitters and spawn shorter-lived, smaller
+    // particles rather than stalling emission
+    EmissionBudget budget;
+    budget.enabled = true;
+    budget.min_lifetime_scale = 0.5f;
+    budget.min_size_scale = 0.75f;
+    system.setEmissionBudget(budget);
+    
+    // Simulate at a fixed 60Hz and interpolate for display
+    system.setFixedTimestep(1.0f / 60.0f, 4);
+    
+    // Sparks fired by dying fireworks rockets, taking the rocket's color
+    EmitterSettings sparks = {
+        0.0f, 0.0f,
+        0.0f,      // rate (unused, fired on death)
+        120.0f,    // speed
+        2.0f,      // size
+        1.2f,      // lifetime
+        EmitterType::Point,
+        0, 255, 0, 255, 0, 255, 0, 255 // color comes from the rocket
+    };
+    sparks.burst_count = 40; // per rocket
+    int spark_emitter = system.addSubEmitter(sparks);
     
     // Different emitter types
     std::vector<EmitterSettings> presets = {
@@ -71,9 +208,9 @@ int main(int argc, char* argv[]) {
             2.0f,      // smaller size
             1.5f,      // shorter lifetime
             EmitterType::Circle,
-            200, 255,  // r range (red)
-            50, 150,   // g range
-            0, 50,     // b range
+            255, 255,  // r range (near white - the
+            225, 255,  // g range  color gradient below
+            200, 255,  // b range  tints it over life)
             200, 255   // a range
         },
         
@@ -104,8 +241,32 @@ int main(int argc, char* argv[]) {
             50, 255,   // b range
             180, 255,  // a range
             true       // colorful_mode = true
+        },
+        
+        // Fireworks (rockets bursting into sparks)
+        {
+            SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT - 50.0f,
+            4.0f,      // few rockets
+            400.0f,    // fast launch
+            3.0f,      // size
+            1.2f,      // burn out near the top
+            EmitterType::Line,
+            100, 255,  // r range
+            100, 255,  // g range
+            100, 255,  // b range
+            230, 255   // a range
         }
     };
+    presets[4].sub_emitter = spark_emitter;
+    
+    // Explosions flash white-hot, cool to deep red and swell before fading.
+    // The gradient multiplies the particle color, so the preset starts white.
+    presets[1].color_over_life = {
+        {0.0f, 255, 255, 255, 255},
+        {0.3f, 255, 200, 120, 255},
+        {1.0f, 160, 40, 20, 0}
+    };
+    presets[1].size_over_life = {{0.0f, 0.6f}, {0.2f, 1.3f}, {1.0f, 0.5f}};
     
     // Start with the fountain preset
     size_t current_preset = 0;
@@ -115,6 +276,14 @@ int main(int argc, char* argv[]) {
     size_t mouse_field = system.addForceField(SCREEN_WIDTH/2, SCREEN_HEIGHT/2, 150.0f, -500.0f);
     bool force_field_enabled = true;
     
+    // View onto the world - wheel zooms about the cursor, arrows pan
+    Camera camera(SCREEN_WIDTH, SCREEN_HEIGHT);
+    auto mouseWorld = [&camera](float& wx, float& wy) {
+        int x, y;
+        SDL_GetMouseState(&x, &y);
+        camera.screenToWorld(static_cast<float>(x), static_cast<float>(y), wx, wy);
+    };
+    
     // Background color
     uint8_t bg_r = 10, bg_g = 10, bg_b = 30;
     bool dynamic_background = false;
@@ -126,6 +295,11 @@ int main(int argc, char* argv[]) {
     
     auto last_time = std::chrono::high_resolution_clock::now();
     
+    // Render timing for --render-stats
+    float render_seconds = 0.0f;
+    int render_frames = 0;
+    long captured_frames = 0;
+    
     // Print instructions
     std::cout << "=== Colorful Particle System Controls ===" << std::endl;
     std::cout << "Mouse Movement: Move force field" << std::endl;
@@ -136,6 +310,9 @@ int main(int argc, char* argv[]) {
     std::cout << "C: Toggle colorful mode for current emitter" << std::endl;
     std::cout << "B: Toggle dynamic background" << std::endl;
     std::cout << "I: Toggle particle interaction" << std::endl;
+    std::cout << "V: Cycle integrator" << std::endl;
+    std::cout << "P: Toggle pipelined simulation/render" << std::endl;
+    std::cout << "Mouse Wheel / Arrows / Home: Zoom, pan, reset camera" << std::endl;
     std::cout << "R: Reset system" << std::endl;
     std::cout << "Q/ESC: Quit" << std::endl;
     std::cout << "=========================================" << std::endl;
@@ -146,8 +323,13 @@ int main(int argc, char* argv[]) {
         float dt = std::chrono::duration<float>(current_time - last_time).count();
         last_time = current_time;
         
-        // Cap delta time to avoid physics issues
-        if (dt > 0.05f) dt = 0.05f;
+        // Cap delta time to avoid huge jumps after a stall (the particle
+        // system additionally limits how many fixed steps it catches up on)
+        if (dt > 0.25f) dt = 0.25f;
+        
+        // Captured output advances at its own frame rate, however long
+        // rendering and writing actually take
+        if (capture) dt = 1.0f / CAPTURE_FPS;
         
         // Handle events
         while (SDL_PollEvent(&e) != 0) {
@@ -155,28 +337,27 @@ int main(int argc, char* argv[]) {
                 quit = true;
             } 
             else if (e.type == SDL_MOUSEMOTION && force_field_enabled) {
+                float x, y;
+                mouseWorld(x, y);
+                system.updateForceField(mouse_field, x, y);
+            }
+            else if (e.type == SDL_MOUSEWHEEL && e.wheel.y != 0) {
                 int x, y;
                 SDL_GetMouseState(&x, &y);
-                system.updateForceField(mouse_field, static_cast<float>(x), static_cast<float>(y));
+                camera.zoomAt(static_cast<float>(x), static_cast<float>(y), e.wheel.y > 0 ? 1.1f : 1.0f / 1.1f);
             }
             else if (e.type == SDL_MOUSEBUTTONDOWN) {
                 if (e.button.button == SDL_BUTTON_LEFT) {
-                    // Create a temporary burst emitter at mouse position
-                    int x, y;
-                    SDL_GetMouseState(&x, &y);
+                    // Fire a one-shot burst at mouse position
+                    float x, y;
+                    mouseWorld(x, y);
                     
                     EmitterSettings burst = presets[1]; // Use explosion preset
                     burst.x = x;
                     burst.y = y;
-                    burst.rate = 500.0f; // One-time burst
-                    
-                    size_t burst_id = system.addEmitter(burst);
+                    burst.burst_count = 50;
                     
-                    // Schedule removal after short time
-                    std::thread([&system, burst_id]() {
-                        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-                        system.removeEmitter(burst_id);
-                    }).detach();
+                    system.addBurst(burst);
                 }
             }
             else if (e.type == SDL_KEYDOWN) {
@@ -189,8 +370,8 @@ int main(int argc, char* argv[]) {
                     case SDLK_SPACE:
                         // Toggle force field strength
                         if (force_field_enabled) {
-                            int x, y;
-                            SDL_GetMouseState(&x, &y);
+                            float x, y;
+                            mouseWorld(x, y);
                             
                             system.removeForceField(mouse_field);
                             
@@ -211,6 +392,7 @@ int main(int argc, char* argv[]) {
                     case SDLK_2:
                     case SDLK_3:
                     case SDLK_4:
+                    case SDLK_5:
                         // Switch emitter type
                         system.removeEmitter(emitter_id);
                         current_preset = e.key.keysym.sym - SDLK_1;
@@ -239,13 +421,134 @@ int main(int argc, char* argv[]) {
                                   << std::endl;
                         break;
                     
+                    case SDLK_v: {
+                        // Cycle integration scheme
+                        static const char* names[] = {"Symplectic Euler", "Velocity Verlet", "Midpoint RK2"};
+                        int next = (static_cast<int>(system.getIntegrator()) + 1) % 3;
+                        system.setIntegrator(static_cast<IntegratorType>(next));
+                        std::cout << "Integrator: " << names[next] << std::endl;
+                        break;
+                    }
+                    
+                    case SDLK_m:
+                        // Reveal the mask image at the cursor
+                        if (mask) {
+                            float x, y;
+                            mouseWorld(x, y);
+                            
+                            EmitterSettings reveal = {
+                                x, y,
+                                0.0f,      // rate (unused for bursts)
+                                10.0f,     // slow drift
+                                2.0f,      // size
+                                3.0f,      // lifetime
+                                EmitterType::Image,
+                                200, 255, 200, 255, 200, 255, 200, 255
+                            };
+                            reveal.burst_count = 20000;
+                            reveal.mask = mask;
+                            system.addBurst(reveal);
+                        }
+                        break;
+                    
+                    case SDLK_g:
+                        // Toggle sprite atlas rendering
+                        use_sprites = !use_sprites && geometry_renderer->isValid();
+                        std::cout << "Sprite rendering: " 
+                                  << (use_sprites ? "ON" : "OFF") 
+                                  << std::endl;
+                        break;
+                    
+                    case SDLK_d:
+                        // Toggle multithreaded CPU rasterization
+                        use_software = !use_software && software_renderer->isValid();
+                        std::cout << "Software rendering: " 
+                                  << (use_software ? "ON" : "OFF") 
+                                  << std::endl;
+                        break;
+                    
+                    case SDLK_n:
+                        // Cycle density view: off, heat colormap, particle colors
+                        if (!use_density) {
+                            use_density = density_renderer->isValid();
+                            density_renderer->setColoring(DensityRenderer::Coloring::Heat);
+                        } else if (density_renderer->getColoring() == DensityRenderer::Coloring::Heat) {
+                            density_renderer->setColoring(DensityRenderer::Coloring::ParticleColor);
+                        } else {
+                            use_density = false;
+                        }
+                        std::cout << "Density view: " 
+                                  << (!use_density ? "OFF" :
+                                      density_renderer->getColoring() == DensityRenderer::Coloring::Heat ?
+                                      "HEAT" : "PARTICLE COLOR") 
+                                  << std::endl;
+                        break;
+                    
+                    case SDLK_x:
+                        // Skip drawing entirely, to measure simulation alone
+                        use_null = !use_null;
+                        std::cout << "Null renderer: " 
+                                  << (use_null ? "ON" : "OFF") 
+                                  << std::endl;
+                        break;
+                    
+                    case SDLK_h:
+                        // Toggle additive HDR glow
+                        use_hdr = !use_hdr && hdr_renderer->isValid();
+                        std::cout << "HDR glow: " 
+                                  << (use_hdr ? "ON" : "OFF") 
+                                  << std::endl;
+                        break;
+                    
+                    case SDLK_t:
+                        // Toggle motion trails (drawn through the HDR buffer)
+                        trails = !trails && hdr_renderer->isValid();
+                        hdr_renderer->setTrailDecay(trails ? 0.85f : 0.0f);
+                        use_hdr = trails || use_hdr;
+                        std::cout << "Motion trails: " 
+                                  << (trails ? "ON" : "OFF") 
+                                  << std::endl;
+                        break;
+                    
+                    case SDLK_p:
+                        // Toggle overlapping simulation with rendering
+                        system.setPipelined(!system.isPipelined());
+                        std::cout << "Pipelined frames: " 
+                                  << (system.isPipelined() ? "ON" : "OFF") 
+                                  << std::endl;
+                        break;
+                    
+                    case SDLK_LEFT:
+                        camera.pan(-PAN_STEP, 0.0f);
+                        break;
+                    
+                    case SDLK_RIGHT:
+                        camera.pan(PAN_STEP, 0.0f);
+                        break;
+                    
+                    case SDLK_UP:
+                        camera.pan(0.0f, -PAN_STEP);
+                        break;
+                    
+                    case SDLK_DOWN:
+                        camera.pan(0.0f, PAN_STEP);
+                        break;
+                    
+                    case SDLK_HOME:
+                        camera.reset();
+                        break;
+                    
                     case SDLK_r:
                         // Reset system
                         system.reset();
+                        spark_emitter = system.addSubEmitter(sparks);
+                        presets[4].sub_emitter = spark_emitter;
                         emitter_id = system.addEmitter(presets[current_preset]);
                         
-                        int x, y;
-                        SDL_GetMouseState(&x, &y);
+                        camera.reset();
+                        
+                        float x, y;
+                        mouseWorld(x, y);
                         mouse_field = system.addForceField(x, y, 150.0f, -500.0f);
                         force_field_enabled = true;
                         break;
@@ -253,8 +556,16 @@ int main(int argc, char* argv[]) {
             }
         }
         
-        // Update particle system
-        system.update(dt);
+        // Keep the force field under the cursor as the camera moves
+        system.setCamera(camera);
+        if (force_field_enabled) {
+            float x, y;
+            mouseWorld(x, y);
+            system.updateForceField(mouse_field, x, y);
+        }
+        
+        // Start simulating this frame (in the background when pipelined)
+        system.beginUpdate(dt);
         
         // Update dynamic background if enabled
         if (dynamic_background) {
@@ -283,13 +594,59 @@ int main(int argc, char* argv[]) {
         SDL_SetRenderDrawColor(renderer, bg_r, bg_g, bg_b, 255);
         SDL_RenderClear(renderer);
         
-        // Render particles
-        system.render(renderer);
+        // Render particles with the selected backend
+        RenderBackend* backend = point_renderer.get();
+        if (use_null) {
+            backend = &null_renderer;
+        } else if (use_density) {
+            backend = density_renderer.get();
+        } else if (use_hdr) {
+            backend = hdr_renderer.get();
+        } else if (use_software) {
+            software_renderer->setBackground(bg_r, bg_g, bg_b);
+            backend = software_renderer.get();
+        } else if (use_sprites) {
+            backend = geometry_renderer.get();
+        }
+        
+        auto render_start = std::chrono::high_resolution_clock::now();
+        hdr_renderer->setFrameTime(dt); // Trails fade by time, not frame count
+        system.render(*backend);
+        if (render_stats) {
+            render_seconds += std::chrono::duration<float>(std::chrono::high_resolution_clock::now() - render_start).count();
+            if (++render_frames == 120) {
+                std::cout << "Render (" << backend->getName() << "): " 
+                          << render_seconds * 1000.0f / render_frames << " ms/frame" 
+                          << std::endl;
+                render_seconds = 0.0f;
+                render_frames = 0;
+            }
+        }
+        
+        // Hand the rendered frame to the capture thread, before the
+        // force field overlay goes on top of it
+        if (capture) {
+            uint32_t* frame = capture->nextFrame();
+            if (SDL_RenderReadPixels(renderer, nullptr, SDL_PIXELFORMAT_ARGB8888, frame,
+                                     SCREEN_WIDTH * static_cast<int>(sizeof(uint32_t))) != 0) {
+                std::cerr << "Frame capture failed! SDL_Error: " << SDL_GetError() << std::endl;
+                capture.reset();
+            } else {
+                capture->submit();
+                if (capture->hasFailed()) {
+                    std::cerr << "Capture output could not be written, stopping capture" << std::endl;
+                    capture.reset();
+                } else if (++captured_frames == capture_frames) {
+                    quit = true;
+                }
+            }
+        }
         
         // Render force field indicator if enabled
         if (force_field_enabled) {
             int x, y;
             SDL_GetMouseState(&x, &y);
+            float zoom = camera.getZoom();
             
             // Draw force field circle
             float strength = system.getForceFieldStrength(mouse_field);
@@ -298,38 +655,51 @@ int main(int argc, char* argv[]) {
             if (strength < 0) {
                 // Draw outer glow (larger, more transparent)
                 SDL_SetRenderDrawColor(renderer, 100, 150, 255, 30);
-                drawCircle(renderer, x, y, 170);
+                drawCircle(renderer, x, y, static_cast<int>(170 * zoom));
                 
                 // Draw inner circle
                 SDL_SetRenderDrawColor(renderer, 100, 150, 255, 100);
-                drawCircle(renderer, x, y, 150);
+                drawCircle(renderer, x, y, static_cast<int>(150 * zoom));
                 
                 // Draw center
                 SDL_SetRenderDrawColor(renderer, 150, 200, 255, 150);
-                drawCircle(renderer, x, y, 30);
+                drawCircle(renderer, x, y, static_cast<int>(30 * zoom));
             } else {
                 // Draw outer glow (larger, more transparent)
                 SDL_SetRenderDrawColor(renderer, 255, 100, 100, 30);
-                drawCircle(renderer, x, y, 170);
+                drawCircle(renderer, x, y, static_cast<int>(170 * zoom));
                 
                 // Draw inner circle
                 SDL_SetRenderDrawColor(renderer, 255, 100, 100, 100);
-                drawCircle(renderer, x, y, 150);
+                drawCircle(renderer, x, y, static_cast<int>(150 * zoom));
                 
                 // Draw center
                 SDL_SetRenderDrawColor(renderer, 255, 150, 150, 150);
-                drawCircle(renderer, x, y, 30);
+                drawCircle(renderer, x, y, static_cast<int>(30 * zoom));
             }
         }
         
+        // Wait for the simulation and publish it for the next render
+        system.endUpdate();
+        
         // Update screen
         SDL_RenderPresent(renderer);
         
-        // Cap to ~60 FPS
-        std::this_thread::sleep_for(std::chrono::milliseconds(16));
+        // Cap to ~60 FPS (capture runs as fast as it can write)
+        if (!capture) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(16));
+        }
     }
     
-    // Cleanup
+    // Finish writing captured frames
+    capture.reset();
+    
+    // Cleanup - textures go before their renderer
+    point_renderer.reset();
+    geometry_renderer.reset();
+    hdr_renderer.reset();
+    software_renderer.reset();
+    density_renderer.reset();
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     SDL_Quit();
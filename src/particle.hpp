@@ -1,23 +1,19 @@
 #pragma once
-#include <SDL2/SDL.h>
 #include <cstdint>
 
 struct Particle {
     float x, y;           // Position
+    float prev_x, prev_y; // Position at the start of the last step
     float vx, vy;         // Velocity
-    float ax, ay;         // Acceleration
+    float ax, ay;         // Acceleration at the end of the last step (Velocity Verlet)
     float lifetime;       // Current lifetime
     float max_lifetime;   // Maximum lifetime
+    float life_ratio;     // lifetime / max_lifetime, refreshed by the update kernel
     float size;           // Particle size
     uint8_t r, g, b, a;   // Color (RGBA)
     bool active = false;  // Whether particle is active
     bool colorful_mode = false; // Rainbow mode
-    
-    void update(float dt);
-    void render(SDL_Renderer* renderer);
-    void applyForce(float fx, float fy);
-    
-private:
-    // Helper function for rainbow colors
-    void HSVtoRGB(float h, float s, float v, uint8_t& r, uint8_t& g, uint8_t& b);
+    int16_t sub_emitter = -1;   // Sub-emitter fired on death, -1 for none
+    uint16_t style = 0;         // Color and size gradients, 0 for the default
+    bool accel_cached = false;  // ax, ay are valid for the start of the next step
 };
@@ -0,0 +1,40 @@
+#include "point_renderer.hpp"
+#include <algorithm>
+
+// Filled circle at a screen position, with a color and radius from
+// shadeParticles
+static void drawParticle(SDL_Renderer* renderer, float px, float py, uint32_t rgba, float radius_f) {
+    // Set draw color
+    SDL_SetRenderDrawColor(renderer, rgba >> 24, (rgba >> 16) & 0xFF, (rgba >> 8) & 0xFF, rgba & 0xFF);
+
+    // Draw particle as filled circle with size based on lifetime
+    int radius = static_cast<int>(radius_f);
+    int cx = static_cast<int>(px);
+    int cy = static_cast<int>(py);
+
+    // Simple filled circle drawing
+    for (int w = -radius; w <= radius; w++) {
+        for (int h = -radius; h <= radius; h++) {
+            if ((w*w + h*h) <= (radius*radius)) {
+                SDL_RenderDrawPoint(renderer, cx + w, cy + h);
+            }
+        }
+    }
+}
+
+void PointRenderer::draw(const FrameSnapshot& view, const ParticleStyle* styles, WorkerPool&) {
+    // Shade a block of particles at a time, then draw them
+    uint32_t colors[SHADE_BLOCK];
+    float radii[SHADE_BLOCK];
+    view.forEachSegment([&](const RenderParticle* segment, size_t count) {
+        for (size_t first = 0; first < count; first += SHADE_BLOCK) {
+            size_t block = std::min(SHADE_BLOCK, count - first);
+            shadeParticles(segment + first, block, view.alpha, styles, colors, radii);
+            for (size_t i = 0; i < block; ++i) {
+                float px, py;
+                view.project(segment[first + i], px, py);
+                drawParticle(renderer, px, py, colors[i], radii[i] * view.view_scale);
+            }
+        }
+    });
+}
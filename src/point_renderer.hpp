@@ -0,0 +1,17 @@
+#pragma once
+#include "render_backend.hpp"
+#include <SDL2/SDL.h>
+
+// The original look: every particle a filled circle of SDL points. Simple
+// and exact, but O(radius^2) draw calls per particle.
+class PointRenderer : public RenderBackend {
+private:
+    SDL_Renderer* renderer;
+
+public:
+    explicit PointRenderer(SDL_Renderer* renderer) : renderer(renderer) {}
+
+    const char* getName() const override { return "points"; }
+
+    void draw(const FrameSnapshot& view, const ParticleStyle* styles, WorkerPool& pool) override;
+};
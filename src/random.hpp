@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+
+// SplitMix64 finalizer - a cheap, well distributed 64-bit mix
+inline uint64_t mixBits(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Derive an independent seed for a numbered child (emitter, particle, ...)
+inline uint64_t deriveSeed(uint64_t seed, uint64_t id) {
+    return mixBits(seed ^ mixBits(id + 0x9E3779B97F4A7C15ULL));
+}
+
+// Counter-based generator: the n-th value of a stream is a pure function of
+// (key, n), so results never depend on which thread draws them or in what
+// order other streams are consumed. Satisfies UniformRandomBitGenerator so
+// it plugs into the std distributions.
+class CounterRng {
+private:
+    uint64_t key;
+    uint64_t counter = 0;
+
+public:
+    using result_type = uint32_t;
+
+    CounterRng(uint64_t seed, uint64_t stream) : key(deriveSeed(seed, stream)) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT32_MAX; }
+
+    result_type operator()() {
+        return static_cast<result_type>(mixBits(key + counter++ * 0x9E3779B97F4A7C15ULL) >> 32);
+    }
+};
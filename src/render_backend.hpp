@@ -0,0 +1,41 @@
+#pragma once
+#include "snapshot.hpp"
+#include "worker_pool.hpp"
+#include <cstddef>
+
+// Something that draws a frame. ParticleSystem::render culls the published
+// snapshot to the camera and hands the result over read-only, so a backend
+// never touches simulation state and can be swapped - or timed - on its own.
+// Backends that need a window or GPU resources acquire them on construction.
+class RenderBackend {
+public:
+    virtual ~RenderBackend() = default;
+
+    // Short name for logs and benchmarks
+    virtual const char* getName() const = 0;
+
+    // False if the backend could not acquire its resources
+    virtual bool isValid() const { return true; }
+
+    // Draw the frame, optionally using the worker pool
+    virtual void draw(const FrameSnapshot& view, const ParticleStyle* styles, WorkerPool& pool) = 0;
+};
+
+// Draws nothing, so benchmarks measure simulation and culling alone
+class NullRenderer : public RenderBackend {
+private:
+    size_t last_count = 0;
+
+public:
+    const char* getName() const override { return "null"; }
+
+    void draw(const FrameSnapshot& view, const ParticleStyle*, WorkerPool&) override {
+        last_count = 0;
+        for (size_t count : view.segment_count) {
+            last_count += count;
+        }
+    }
+
+    // Particles that would have been drawn last frame
+    size_t getLastCount() const { return last_count; }
+};
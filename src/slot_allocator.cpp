@@ -0,0 +1,40 @@
+#include "slot_allocator.hpp"
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+void SlotAllocator::reset(size_t capacity) {
+    slots.resize(capacity);
+    for (size_t i = 0; i < capacity; ++i) {
+        slots[i] = static_cast<uint32_t>(i);
+    }
+    available = capacity;
+    cursor.store(0);
+}
+
+void SlotAllocator::compact(const std::vector<size_t>& starts, const std::vector<size_t>& counts,
+                            const std::vector<uint8_t>& whole) {
+    // Segments only move left, so each memmove reads data not yet overwritten,
+    // and a whole segment never reaches past its own partition
+    size_t total = 0;
+    for (size_t i = 0; i < starts.size(); ++i) {
+        if (whole[i]) {
+            std::iota(slots.data() + total, slots.data() + total + counts[i], static_cast<uint32_t>(starts[i]));
+        } else if (starts[i] != total && counts[i] > 0) {
+            std::memmove(slots.data() + total, slots.data() + starts[i], counts[i] * sizeof(uint32_t));
+        }
+        total += counts[i];
+    }
+    available = total;
+    cursor.store(0);
+}
+
+std::span<const uint32_t> SlotAllocator::reserve(size_t count) {
+    if (count == 0) return {};
+    
+    size_t begin = cursor.fetch_add(count);
+    if (begin >= available) return {};
+    
+    size_t end = std::min(begin + count, available);
+    return {slots.data() + begin, end - begin};
+}
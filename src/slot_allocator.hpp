@@ -0,0 +1,45 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// List of free particle slots. The update kernel rebuilds it every step, one
+// segment per partition, and compact() joins the segments in partition
+// order. Emitters then reserve contiguous runs of the list with a single
+// atomic fetch_add each, so they can fill their particles in parallel.
+class SlotAllocator {
+private:
+    std::vector<uint32_t> slots;
+    size_t available = 0;           // Valid entries in slots
+    std::atomic<size_t> cursor{0};  // Entries handed out since the last rebuild
+    
+public:
+    // Mark every slot in [0, capacity) free
+    void reset(size_t capacity);
+    
+    // Partition segment to write free slot indices into, starting at offset
+    uint32_t* segment(size_t offset) { return slots.data() + offset; }
+    
+    // Join per-partition segments (at starts, with counts) into one list.
+    // A segment flagged whole has every slot of its partition free and is
+    // written here instead of by the kernel.
+    void compact(const std::vector<size_t>& starts, const std::vector<size_t>& counts,
+                 const std::vector<uint8_t>& whole);
+    
+    // Claim up to count free slots; may return fewer when the pool is full
+    std::span<const uint32_t> reserve(size_t count);
+    
+    // Entries handed out since the last rebuild, all from the front of the list
+    size_t reserved() const {
+        return std::min(cursor.load(std::memory_order_relaxed), available);
+    }
+    
+    // Free slots not yet reserved
+    size_t remaining() const {
+        size_t used = cursor.load(std::memory_order_relaxed);
+        return used < available ? available - used : 0;
+    }
+};
@@ -0,0 +1,83 @@
+#include "snapshot.hpp"
+#include "color_lut.hpp"
+#include <algorithm>
+#include <cmath>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Hue turns per unit of life ratio and per pixel of x + y, in LUT steps
+static constexpr float HUE_PER_LIFE = static_cast<float>(HUE_LUT_SIZE);
+static constexpr float HUE_PER_PIXEL = 0.1f / 360.0f * HUE_LUT_SIZE;
+
+// Rainbow hue cycles with lifetime and position, wrapped into the LUT
+static inline uint32_t hueIndex(const RenderParticle& p, float alpha) {
+    float px, py;
+    p.interpolate(alpha, px, py);
+    float hue = p.life_ratio * HUE_PER_LIFE + (px + py) * HUE_PER_PIXEL;
+    return static_cast<uint32_t>(static_cast<int32_t>(hue)) & (HUE_LUT_SIZE - 1);
+}
+
+static void hueIndices(const RenderParticle* particles, size_t count, float alpha, uint32_t* out) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128 blend = _mm_set1_ps(alpha);
+    const __m128 per_life = _mm_set1_ps(HUE_PER_LIFE);
+    const __m128 per_pixel = _mm_set1_ps(HUE_PER_PIXEL);
+    const __m128i wrap = _mm_set1_epi32(HUE_LUT_SIZE - 1);
+    for (; i + 4 <= count; i += 4) {
+        const RenderParticle* p = particles + i;
+        __m128 x = _mm_setr_ps(p[0].x, p[1].x, p[2].x, p[3].x);
+        __m128 y = _mm_setr_ps(p[0].y, p[1].y, p[2].y, p[3].y);
+        __m128 prev_x = _mm_setr_ps(p[0].prev_x, p[1].prev_x, p[2].prev_x, p[3].prev_x);
+        __m128 prev_y = _mm_setr_ps(p[0].prev_y, p[1].prev_y, p[2].prev_y, p[3].prev_y);
+        __m128 life = _mm_setr_ps(p[0].life_ratio, p[1].life_ratio, p[2].life_ratio, p[3].life_ratio);
+        
+        __m128 px = _mm_add_ps(prev_x, _mm_mul_ps(_mm_sub_ps(x, prev_x), blend));
+        __m128 py = _mm_add_ps(prev_y, _mm_mul_ps(_mm_sub_ps(y, prev_y), blend));
+        __m128 hue = _mm_add_ps(_mm_mul_ps(life, per_life), _mm_mul_ps(_mm_add_ps(px, py), per_pixel));
+        __m128i index = _mm_and_si128(_mm_cvttps_epi32(hue), wrap);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), index);
+    }
+#endif
+    for (; i < count; ++i) {
+        out[i] = hueIndex(particles[i], alpha);
+    }
+}
+
+// Per-channel product of two packed colors
+static inline uint32_t modulate(uint32_t c, uint32_t m) {
+    uint32_t out = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        uint32_t channel = ((c >> shift) & 0xFF) * ((m >> shift) & 0xFF);
+        out |= ((channel + 127) / 255) << shift;
+    }
+    return out;
+}
+
+void shadeParticles(const RenderParticle* particles, size_t count, float alpha,
+                    const ParticleStyle* styles, uint32_t* colors, float* radii) {
+    hueIndices(particles, count, alpha, colors);
+    
+    // Color and size transition based on lifetime, one table load each
+    for (size_t i = 0; i < count; ++i) {
+        const RenderParticle& p = particles[i];
+        const ParticleStyle& style = styles[p.style];
+        size_t age = gradientIndex(p.life_ratio);
+        
+        uint32_t base = p.colorful_mode ? (HUE_LUT[colors[i]] & 0xFFFFFF00u) | p.a
+                                        : packRGBA(p.r, p.g, p.b, p.a);
+        colors[i] = modulate(base, style.color[age]);
+        radii[i] = p.size * style.size[age];
+    }
+}
+
+void FrameSnapshot::allocate(size_t capacity, size_t segments) {
+    particles.allocate(capacity);
+    segment_start.assign(segments, 0);
+    segment_count.assign(segments, 0);
+}
+
+void FrameSnapshot::clear() {
+    std::fill(segment_count.begin(), segment_count.end(), 0);
+}
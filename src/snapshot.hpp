@@ -0,0 +1,79 @@
+#pragma once
+#include "first_touch_buffer.hpp"
+#include "color_lut.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Render-relevant copy of a live particle, written by the simulation
+struct RenderParticle {
+    float x, y;            // Position at the end of the step
+    float prev_x, prev_y;  // Position at the start of the step
+    float size;            // Particle size
+    float life_ratio;      // Remaining fraction of lifetime
+    uint8_t r, g, b, a;    // Color (RGBA)
+    bool colorful_mode;    // Rainbow mode
+    uint16_t style;        // Index into the system's gradient styles
+    
+    // Position between the previous and current step
+    void interpolate(float alpha, float& px, float& py) const {
+        px = prev_x + (x - prev_x) * alpha;
+        py = prev_y + (y - prev_y) * alpha;
+    }
+    
+};
+
+
+// Particles shaded per call by the renderer, sized to keep colors on the stack
+constexpr size_t SHADE_BLOCK = 256;
+
+// Packed 0xRRGGBBAA draw colors and radii for count particles (at most
+// SHADE_BLOCK): initial colors or rainbow hues from HUE_LUT, times the
+// style's color and size at the particle's age. Hue indices are computed
+// four particles at a time where SSE2 is available.
+void shadeParticles(const RenderParticle* particles, size_t count, float alpha,
+                    const ParticleStyle* styles, uint32_t* colors, float* radii);
+
+// One frame of render state. Each worker fills a contiguous segment starting
+// at segment_start[id], so no synchronization is needed while writing.
+struct FrameSnapshot {
+    FirstTouchBuffer<RenderParticle> particles;
+    std::vector<size_t> segment_start;
+    std::vector<size_t> segment_count;
+    float alpha = 1.0f;    // Interpolation between previous and current position
+    
+    // Camera transform: screen = world * view_scale + (view_x, view_y)
+    float view_scale = 1.0f;
+    float view_x = 0.0f, view_y = 0.0f;
+    
+    // Interpolated screen position of a particle
+    void project(const RenderParticle& p, float& px, float& py) const {
+        p.interpolate(alpha, px, py);
+        px = px * view_scale + view_x;
+        py = py * view_scale + view_y;
+    }
+    
+    // Reserve storage; segments are constructed by the partitions filling them
+    void allocate(size_t capacity, size_t segments);
+    void clear();
+    
+    // Call fn(first, count) for each contiguous run of particles
+    template <typename Fn>
+    void forEachSegment(Fn&& fn) const {
+        for (size_t s = 0; s < segment_start.size(); ++s) {
+            if (segment_count[s] > 0) {
+                fn(particles.data() + segment_start[s], segment_count[s]);
+            }
+        }
+    }
+    
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (size_t s = 0; s < segment_start.size(); ++s) {
+            const RenderParticle* begin = particles.data() + segment_start[s];
+            for (size_t i = 0; i < segment_count[s]; ++i) {
+                fn(begin[i]);
+            }
+        }
+    }
+};
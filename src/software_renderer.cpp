@@ -0,0 +1,118 @@
+#include "software_renderer.hpp"
+#include <algorithm>
+#include <cmath>
+
+// dst + (src - dst) * a / 255 per channel, alpha kept opaque
+static inline uint32_t blendOver(uint32_t dst, uint32_t rgba, uint32_t a) {
+    uint32_t out = 0xFF000000u;
+    for (int channel = 0; channel < 3; ++channel) {
+        int shift = 16 - channel * 8;
+        int d = (dst >> shift) & 0xFF;
+        int s = (rgba >> (24 - channel * 8)) & 0xFF;
+        out |= static_cast<uint32_t>(d + ((s - d) * static_cast<int>(a) + 127) / 255) << shift;
+    }
+    return out;
+}
+
+SoftwareRenderer::SoftwareRenderer(SDL_Renderer* renderer, int width, int height)
+    : renderer(renderer), width(width), height(height),
+      pixels(static_cast<size_t>(width) * height, 0)
+{
+    texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING,
+                                width, height);
+    if (texture) {
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_NONE);
+    }
+}
+
+SoftwareRenderer::~SoftwareRenderer() {
+    if (texture) {
+        SDL_DestroyTexture(texture);
+    }
+}
+
+void SoftwareRenderer::draw(const FrameSnapshot& snapshot, const ParticleStyle* styles, WorkerPool& pool) {
+    if (!texture) return;
+
+    // Shade and bin each snapshot segment, then rasterize each tile
+    sprites.resize(snapshot.particles.size());
+    unsigned int segments = static_cast<unsigned int>(snapshot.segment_start.size());
+    bins.resize(width, height, segments);
+    pool.run(segments, [&](unsigned int task, unsigned int) {
+        shadeSegment(snapshot, task, styles);
+    });
+
+    pool.run(static_cast<unsigned int>(bins.getTileCount()), [&](unsigned int tile, unsigned int) {
+        rasterizeTile(static_cast<int>(tile));
+    });
+
+    SDL_UpdateTexture(texture, nullptr, pixels.data(), width * static_cast<int>(sizeof(uint32_t)));
+    SDL_RenderCopy(renderer, texture, nullptr, nullptr);
+}
+
+void SoftwareRenderer::shadeSegment(const FrameSnapshot& snapshot, size_t segment, const ParticleStyle* styles) {
+    size_t start = snapshot.segment_start[segment];
+    const RenderParticle* particles = snapshot.particles.data() + start;
+    size_t count = snapshot.segment_count[segment];
+    bins.clear(segment);
+
+    uint32_t colors[SHADE_BLOCK];
+    float radii[SHADE_BLOCK];
+    for (size_t first = 0; first < count; first += SHADE_BLOCK) {
+        size_t block = std::min(SHADE_BLOCK, count - first);
+        shadeParticles(particles + first, block, snapshot.alpha, styles, colors, radii);
+
+        for (size_t i = 0; i < block; ++i) {
+            float px, py;
+            snapshot.project(particles[first + i], px, py);
+
+            // Same footprint as the point-drawn circle: 2r+1 pixels around (x, y)
+            Sprite& sprite = sprites[start + first + i];
+            sprite = {static_cast<int>(px), static_cast<int>(py), static_cast<int>(radii[i] * snapshot.view_scale), colors[i]};
+            bins.add(segment, static_cast<uint32_t>(start + first + i),
+                     sprite.x - sprite.radius, sprite.y - sprite.radius,
+                     sprite.x + sprite.radius, sprite.y + sprite.radius);
+        }
+    }
+}
+
+void SoftwareRenderer::rasterizeTile(int tile) {
+    int tile_x0, tile_y0, tile_x1, tile_y1;
+    bins.tileRect(tile, tile_x0, tile_y0, tile_x1, tile_y1);
+
+    for (int y = tile_y0; y < tile_y1; ++y) {
+        uint32_t* row = pixels.data() + static_cast<size_t>(y) * width;
+        std::fill(row + tile_x0, row + tile_x1, background);
+    }
+
+    bins.forEach(tile, [&](uint32_t index) {
+        const Sprite& sprite = sprites[index];
+        uint32_t alpha = sprite.rgba & 0xFF;
+
+        // Single pixel particles skip shape rasterization entirely
+        if (sprite.radius == 0) {
+            uint32_t& px = pixels[static_cast<size_t>(sprite.y) * width + sprite.x];
+            px = blendOver(px, sprite.rgba, alpha);
+            return;
+        }
+
+        int y0 = std::max(sprite.y - sprite.radius, tile_y0);
+        int y1 = std::min(sprite.y + sprite.radius, tile_y1 - 1);
+        int x0 = std::max(sprite.x - sprite.radius, tile_x0);
+        int x1 = std::min(sprite.x + sprite.radius, tile_x1 - 1);
+        float edge = sprite.radius + 0.5f;
+        for (int y = y0; y <= y1; ++y) {
+            float dy = static_cast<float>(y - sprite.y);
+            uint32_t* px = pixels.data() + static_cast<size_t>(y) * width + x0;
+            for (int x = x0; x <= x1; ++x, ++px) {
+                // Coverage falls off over one pixel at the edge
+                float dx = static_cast<float>(x - sprite.x);
+                float coverage = std::clamp(edge - std::sqrt(dx*dx + dy*dy), 0.0f, 1.0f);
+                uint32_t a = static_cast<uint32_t>(alpha * coverage + 0.5f);
+                if (a > 0) {
+                    *px = blendOver(*px, sprite.rgba, a);
+                }
+            }
+        }
+    });
+}
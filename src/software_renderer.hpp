@@ -0,0 +1,52 @@
+#pragma once
+#include "render_backend.hpp"
+#include "tile_binner.hpp"
+#include <SDL2/SDL.h>
+#include <vector>
+
+// CPU rasterizer for the alpha-blended look. Particles are shaded and
+// binned into screen tiles one snapshot segment per task, then each tile is
+// cleared to the background and its particles blended in draw order by one
+// task - no atomics, no two threads on the same pixel. The finished frame
+// replaces the render target's contents.
+class SoftwareRenderer : public RenderBackend {
+private:
+    // Shaded particle ready to rasterize
+    struct Sprite {
+        int x, y;      // Center pixel
+        int radius;
+        uint32_t rgba; // Packed 0xRRGGBBAA
+    };
+
+    SDL_Renderer* renderer;
+    int width, height;
+    uint32_t background = 0xFF000000u; // ARGB8888
+    SDL_Texture* texture = nullptr;
+    std::vector<uint32_t> pixels;      // ARGB8888 frame
+    std::vector<Sprite> sprites;       // Indexed like the snapshot's particles
+    TileBinner bins;
+
+public:
+    SoftwareRenderer(SDL_Renderer* renderer, int width, int height);
+    ~SoftwareRenderer();
+
+    SoftwareRenderer(const SoftwareRenderer&) = delete;
+    SoftwareRenderer& operator=(const SoftwareRenderer&) = delete;
+
+    const char* getName() const override { return "software"; }
+
+    // False if the texture could not be created (see SDL_GetError)
+    bool isValid() const override { return texture != nullptr; }
+
+    // Color every tile starts from
+    void setBackground(uint8_t r, uint8_t g, uint8_t b) {
+        background = 0xFF000000u | (uint32_t{r} << 16) | (uint32_t{g} << 8) | b;
+    }
+
+    // Rasterize a frame and copy it to the render target
+    void draw(const FrameSnapshot& snapshot, const ParticleStyle* styles, WorkerPool& pool) override;
+
+private:
+    void shadeSegment(const FrameSnapshot& snapshot, size_t segment, const ParticleStyle* styles);
+    void rasterizeTile(int tile);
+};
@@ -0,0 +1,88 @@
+#include "sprite_atlas.hpp"
+#include <algorithm>
+#include <cmath>
+
+SpriteAtlas::SpriteAtlas(SDL_Renderer* renderer) {
+    // One row of cells, each 2r+1 pixels wide plus a transparent border so
+    // filtering never bleeds in from the neighbour
+    int x = 0;
+    for (int r = 0; r <= MAX_RADIUS; ++r) {
+        int size = 2 * r + 1;
+        cells[r] = {x + 1, 1, size, size};
+        x += size + 2;
+    }
+    texture_width = x;
+    texture_height = 2 * MAX_RADIUS + 3;
+
+    std::vector<uint8_t> pixels(static_cast<size_t>(texture_width) * texture_height * 4, 0);
+    for (int r = 0; r <= MAX_RADIUS; ++r) {
+        const SDL_Rect& cell = cells[r];
+        float center = r + 0.5f;
+        float edge = std::max(r + 0.5f, 1.0f); // Radius 0 is one solid pixel
+        for (int py = 0; py < cell.h; ++py) {
+            for (int px = 0; px < cell.w; ++px) {
+                // Coverage falls off over one pixel at the edge
+                float dx = px + 0.5f - center;
+                float dy = py + 0.5f - center;
+                float coverage = std::clamp(edge - std::sqrt(dx*dx + dy*dy), 0.0f, 1.0f);
+
+                uint8_t* out = &pixels[(static_cast<size_t>(cell.y + py) * texture_width + cell.x + px) * 4];
+                out[0] = out[1] = out[2] = 255;
+                out[3] = static_cast<uint8_t>(coverage * 255.0f + 0.5f);
+            }
+        }
+    }
+
+    texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC,
+                                texture_width, texture_height);
+    if (!texture) return;
+    SDL_UpdateTexture(texture, nullptr, pixels.data(), texture_width * 4);
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+}
+
+SpriteAtlas::~SpriteAtlas() {
+    if (texture) {
+        SDL_DestroyTexture(texture);
+    }
+}
+
+void SpriteAtlas::add(float x, float y, float radius, uint32_t rgba) {
+    // Same footprint as the point-drawn circle: 2r+1 pixels around (x, y).
+    // Radii past the largest baked cell stretch it.
+    int r = std::max(static_cast<int>(radius), 0);
+    const SDL_Rect& cell = cells[std::min(r, MAX_RADIUS)];
+    float x0 = static_cast<float>(static_cast<int>(x) - r);
+    float y0 = static_cast<float>(static_cast<int>(y) - r);
+    float x1 = x0 + 2 * r + 1;
+    float y1 = y0 + 2 * r + 1;
+
+    float u0 = static_cast<float>(cell.x) / texture_width;
+    float v0 = static_cast<float>(cell.y) / texture_height;
+    float u1 = static_cast<float>(cell.x + cell.w) / texture_width;
+    float v1 = static_cast<float>(cell.y + cell.h) / texture_height;
+
+    SDL_Color color = {static_cast<Uint8>(rgba >> 24), static_cast<Uint8>(rgba >> 16),
+                       static_cast<Uint8>(rgba >> 8), static_cast<Uint8>(rgba)};
+    vertices.push_back({{x0, y0}, color, {u0, v0}});
+    vertices.push_back({{x1, y0}, color, {u1, v0}});
+    vertices.push_back({{x1, y1}, color, {u1, v1}});
+    vertices.push_back({{x0, y1}, color, {u0, v1}});
+}
+
+void SpriteAtlas::flush(SDL_Renderer* renderer) {
+    if (vertices.empty() || !texture) {
+        vertices.clear();
+        return;
+    }
+
+    // The index pattern is the same for every quad, so only extend it
+    size_t quads = vertices.size() / 4;
+    for (size_t q = indices.size() / 6; q < quads; ++q) {
+        int base = static_cast<int>(q * 4);
+        indices.insert(indices.end(), {base, base + 1, base + 2, base, base + 2, base + 3});
+    }
+
+    SDL_RenderGeometry(renderer, texture, vertices.data(), static_cast<int>(vertices.size()),
+                       indices.data(), static_cast<int>(quads * 6));
+    vertices.clear();
+}
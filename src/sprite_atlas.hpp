@@ -0,0 +1,38 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <vector>
+
+// Anti-aliased filled circles for every integer radius up to MAX_RADIUS,
+// prerasterized into one white texture at startup. Particles are queued as
+// textured quads tinted with per-vertex color and drawn with a single
+// SDL_RenderGeometry call, so each costs O(1) instead of O(radius^2) points.
+class SpriteAtlas {
+public:
+    static constexpr int MAX_RADIUS = 32;
+
+private:
+    SDL_Texture* texture = nullptr;
+    int texture_width = 0;
+    int texture_height = 0;
+    SDL_Rect cells[MAX_RADIUS + 1];   // Circle of radius r, with a pixel of padding
+    std::vector<SDL_Vertex> vertices; // Quads queued since the last flush
+    std::vector<int> indices;         // Two triangles per quad, only ever grows
+
+public:
+    explicit SpriteAtlas(SDL_Renderer* renderer);
+    ~SpriteAtlas();
+
+    SpriteAtlas(const SpriteAtlas&) = delete;
+    SpriteAtlas& operator=(const SpriteAtlas&) = delete;
+
+    // False if the texture could not be created (see SDL_GetError)
+    bool isValid() const { return texture != nullptr; }
+
+    // Queue a circle centered at (x, y) in packed 0xRRGGBBAA color. Larger
+    // radii than MAX_RADIUS stretch the largest sprite.
+    void add(float x, float y, float radius, uint32_t rgba);
+
+    // Draw everything queued and empty the queue
+    void flush(SDL_Renderer* renderer);
+};
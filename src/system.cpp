@@ -2,9 +2,27 @@
 #include "system.hpp"
 #include <cmath>
 #include <algorithm>
+#include <chrono>
 
 ParticleSystem::ParticleSystem(size_t max_particles, unsigned int thread_count, int screen_width, int screen_height)
-    : particles(max_particles), sync_point(thread_count + 1) // +1 for main thread
+    : ParticleSystem(max_particles, std::make_shared<WorkerPool>(thread_count), screen_width, screen_height)
+{
+}
+
+ParticleSystem::ParticleSystem(size_t max_particles, std::shared_ptr<WorkerPool> pool, int screen_width, int screen_height)
+    : particles(max_particles), worker_pool(std::move(pool)),
+      partition_count(worker_pool->isPinned() ?
+                      std::min(worker_pool->affineConcurrency(), WorkerPool::MAX_AFFINE_TASKS) :
+                      worker_pool->concurrency()),
+      partition_starts(partition_count, 0),
+      worker_live_counts(partition_count, 0),
+      worker_free_counts(partition_count, 0),
+      spawn_queue(max_particles),
+      worker_spawn_counts(partition_count, 0),
+      spawn_offsets(partition_count, 0),
+      task_kernel_ns(partition_count, 0.0f),
+      partition_skipped(partition_count, 0),
+      camera(screen_width, screen_height)
 {
     // Initialize grid dimensions based on screen size
     GRID_WIDTH = static_cast<int>(screen_width / CELL_SIZE) + 2;  // +2 for borders
@@ -12,27 +30,156 @@ ParticleSystem::ParticleSystem(size_t max_particles, unsigned int thread_count,
     
     // Pre-allocate the spatial grid
     spatial_grid.resize(GRID_WIDTH * GRID_HEIGHT);
+    collider_grid.resize(GRID_WIDTH * GRID_HEIGHT);
     
-    // Initialize all particles as inactive
-    for (auto& p : particles) {
-        p.active = false;
+    // Each partition captures its live particles into its own snapshot segment
+    front_snapshot.allocate(max_particles, partition_count);
+    back_snapshot.allocate(max_particles, partition_count);
+    view_snapshot.allocate(max_particles, partition_count);
+    for (unsigned int i = 0; i < partition_count; ++i) {
+        size_t start, end;
+        partitionRange(i, start, end);
+        partition_starts[i] = start;
+        worker_free_counts[i] = end - start;
+        front_snapshot.segment_start[i] = start;
+        back_snapshot.segment_start[i] = start;
+        view_snapshot.segment_start[i] = start;
     }
     
-    // Initialize worker threads
-    for (unsigned int i = 0; i < thread_count; ++i) {
-        worker_threads.emplace_back([this, i, thread_count]() {
-            this->workerFunction(i, thread_count);
-        });
-    }
+    // Every slot starts out free
+    free_slots.reset(max_particles);
+    
+    styles.push_back(bakeStyle({}, {}));
+    
+    // Initialize all particles as inactive. On a pinned pool every partition
+    // is first touched by the worker that will always update it, so its
+    // pages are allocated on that worker's NUMA node.
+    worker_pool->run(partition_count, [this](unsigned int id, unsigned int) {
+        size_t start, end;
+        partitionRange(id, start, end);
+        particles.construct(start, end);
+        front_snapshot.particles.construct(start, end);
+        back_snapshot.particles.construct(start, end);
+        view_snapshot.particles.construct(start, end);
+        spawn_queue.construct(start, end);
+    }, worker_pool->isPinned());
 }
 
 ParticleSystem::~ParticleSystem() {
-    running.store(false);
-    // No need to join threads as std::jthread handles it
+    // Let an in-flight pipelined frame finish, then stop the pipeline thread.
+    // Worker threads are stopped and joined by ~WorkerPool once the last
+    // system using the pool is gone.
+    pipeline_busy.wait(true);
+    pipeline_thread.request_stop();
 }
 
 void ParticleSystem::update(float dt) {
-    current_dt.store(dt);
+    simulate(dt);
+    publishSnapshot();
+}
+
+void ParticleSystem::beginUpdate(float dt) {
+    if (!pipelined) {
+        update(dt);
+        return;
+    }
+    
+    // Hand the frame to the pipeline thread
+    pipeline_dt = dt;
+    pipeline_busy.store(true);
+    pipeline_busy.notify_one();
+}
+
+void ParticleSystem::endUpdate() {
+    if (!pipelined) return;
+    
+    pipeline_busy.wait(true);
+    publishSnapshot();
+}
+
+void ParticleSystem::setPipelined(bool enabled) {
+    // Only valid between frames, so nothing is in flight here
+    pipelined = enabled;
+    if (pipelined && !pipeline_thread.joinable()) {
+        pipeline_thread = std::jthread([this](std::stop_token stop) {
+            this->pipelineFunction(stop);
+        });
+    }
+}
+
+void ParticleSystem::pipelineFunction(std::stop_token stop) {
+    // A stop request wakes the thread as if a frame had arrived
+    std::stop_callback wake(stop, [this]() {
+        pipeline_busy.store(true);
+        pipeline_busy.notify_one();
+    });
+    
+    while (true) {
+        pipeline_busy.wait(false);
+        if (stop.stop_requested()) return;
+        
+        simulate(pipeline_dt);
+        
+        pipeline_busy.store(false);
+        pipeline_busy.notify_one();
+    }
+}
+
+void ParticleSystem::publishSnapshot() {
+    if (snapshot_captured) {
+        std::swap(front_snapshot, back_snapshot);
+        snapshot_captured = false;
+    }
+    front_snapshot.alpha = interpolation_alpha;
+}
+
+void ParticleSystem::simulate(float dt) {
+    // Colliders are moved once per frame, so their velocity spans the whole
+    // frame and every substep below collides against the same motion
+    updateColliders(dt);
+    
+    if (!fixed_timestep_enabled) {
+        step(dt, true);
+        interpolation_alpha = 1.0f;
+        return;
+    }
+    
+    time_accumulator += dt;
+    
+    // Run whole steps, but never more than the catch-up budget. Only the last
+    // one needs to capture render state.
+    int steps = std::min(static_cast<int>(time_accumulator / fixed_step), max_substeps);
+    for (int i = 0; i < steps; ++i) {
+        step(fixed_step, i == steps - 1);
+        time_accumulator -= fixed_step;
+    }
+    
+    // Drop time we could not catch up on rather than spiralling
+    if (time_accumulator >= fixed_step) {
+        time_accumulator = std::fmod(time_accumulator, fixed_step);
+    }
+    
+    // How far between the last two steps the rendered frame lies
+    interpolation_alpha = time_accumulator / fixed_step;
+}
+
+void ParticleSystem::setFixedTimestep(float step_size, int max_steps_per_update) {
+    fixed_timestep_enabled = step_size > 0.0f;
+    fixed_step = step_size;
+    max_substeps = std::max(1, max_steps_per_update);
+    time_accumulator = 0.0f;
+}
+
+void ParticleSystem::disableFixedTimestep() {
+    fixed_timestep_enabled = false;
+    time_accumulator = 0.0f;
+    interpolation_alpha = 1.0f;
+}
+
+void ParticleSystem::step(float dt, bool capture) {
+    current_dt = dt;
+    capture_step = capture;
+    reuse_acceleration = acceleration_cache_valid;
     
     // Update spatial grid for particle interaction
     if (particle_interaction_enabled) {
@@ -40,23 +187,290 @@ void ParticleSystem::update(float dt) {
     }
     
     // Emit new particles
+    size_t emitted = emitParticles(dt);
+    
+    if (active_count == 0 && emitted == 0) {
+        // Nothing alive - leave the workers parked
+        active_tasks = 0;
+        if (capture) {
+            back_snapshot.clear();
+            snapshot_captured = true;
+        }
+        return;
+    }
+    
+    // Pinned pools keep each partition on the thread that first touched it;
+    // otherwise adaptive mode may fold partitions into fewer tasks
+    bool affine = worker_pool->isPinned();
+    
+    // A partition the last step left empty is skipped unless this step's
+    // emission reserved some of its slots: all it would do is list every
+    // slot free again, which compact() does instead. The free list holds
+    // partitions in order, and reservations take it from the front.
+    size_t reserved = free_slots.reserved();
+    size_t free_before = 0;
+    size_t scanned = 0;
+    update_list.clear();
+    for (unsigned int id = 0; id < partition_count; ++id) {
+        size_t start, end;
+        partitionRange(id, start, end);
+        partition_skipped[id] = worker_live_counts[id] == 0 && free_before >= reserved;
+        free_before += worker_free_counts[id];
+        if (partition_skipped[id]) {
+            worker_free_counts[id] = end - start;
+            worker_spawn_counts[id] = 0;
+            if (capture) {
+                back_snapshot.segment_count[id] = 0;
+            }
+        } else {
+            scanned += end - start;
+        }
+        
+        // Affine task i must get partition i, skipped or not
+        if (affine || !partition_skipped[id]) {
+            update_list.push_back(id);
+        }
+    }
+    
+    unsigned int tasks = affine ? partition_count :
+                         adaptive_workers ? chooseTaskCount(scanned, update_list.size()) :
+                         static_cast<unsigned int>(update_list.size());
+    
+    // Run the update tasks, each over a contiguous group of the partitions
+    // left to update, and wait for them to finish. Each task times its own
+    // kernel work.
+    worker_pool->run(tasks, [this](unsigned int task, unsigned int task_count) {
+        auto start_time = std::chrono::steady_clock::now();
+        size_t first = task * update_list.size() / task_count;
+        size_t last = (task + 1) * update_list.size() / task_count;
+        for (size_t k = first; k < last; ++k) {
+            if (!partition_skipped[update_list[k]]) {
+                updatePartition(update_list[k]);
+            }
+        }
+        task_kernel_ns[task] = std::chrono::duration<float, std::nano>(
+            std::chrono::steady_clock::now() - start_time).count();
+    }, affine);
+    active_tasks = tasks;
+    
+    // Only Velocity Verlet refreshes the cache; others let it go stale
+    acceleration_cache_valid = integrator == IntegratorType::VelocityVerlet;
+    
+    // Combine per-partition results in a fixed order
+    active_count = 0;
+    for (size_t count : worker_live_counts) {
+        active_count += count;
+    }
+    free_slots.compact(partition_starts, worker_free_counts, partition_skipped);
+    
+    if (capture) {
+        snapshot_captured = true;
+    }
+    
+    // Track kernel cost per scanned slot, since the kernel walks every slot
+    // of a partition whether it is live or not. Only time inside the tasks
+    // counts, not wakeups or waiting on the slowest task.
+    float kernel_ns = 0.0f;
+    for (unsigned int task = 0; task < tasks; ++task) {
+        kernel_ns += task_kernel_ns[task];
+    }
+    ns_per_slot += (kernel_ns / scanned - ns_per_slot) * 0.1f;
+}
+
+size_t ParticleSystem::emitParticles(float dt) {
+    if (emitters.empty() && bursts.empty()) return emitChildren();
+    
+    emit_sources.clear();
     for (auto& emitter : emitters) {
-        emitter.update(dt, particles);
+        emit_sources.push_back(&emitter);
+    }
+    for (auto& burst : bursts) {
+        emit_sources.push_back(&burst);
+    }
+    
+    // Emission clocks advance serially - cheap, and keeps counts deterministic.
+    // Under budget pressure rates drop by priority and particles get cheaper.
+    float pressure = budget.enabled ? budget.pressure(free_slots.remaining(), particles.size()) : 0.0f;
+    emit_counts.resize(emit_sources.size());
+    for (size_t i = 0; i < emit_sources.size(); ++i) {
+        Emitter& emitter = *emit_sources[i];
+        if (budget.enabled) {
+            emit_counts[i] = emitter.prepare(dt, budget.rateScale(pressure, emitter.getPriority()));
+            emitter.setLevelOfDetail(budget.lifetimeScale(pressure), budget.sizeScale(pressure));
+        } else {
+            emit_counts[i] = emitter.prepare(dt);
+        }
+    }
+    
+    // Whatever still does not fit is shared out by priority
+    if (budget.enabled) {
+        emit_priorities.resize(emit_sources.size());
+        for (size_t i = 0; i < emit_sources.size(); ++i) {
+            emit_priorities[i] = emit_sources[i]->getPriority();
+        }
+        budget.share(emit_counts, emit_priorities, free_slots.remaining());
     }
     
-    // Signal worker threads to start processing
-    sync_point.arrive_and_wait();
+    // Reserve every emitter's block in emitter order, then cut the work into
+    // jobs. Large batches - a big burst or an image reveal - are split into
+    // chunks with their streams claimed up front, so one emitter's fill
+    // spreads over the pool and still matches a serial fill.
+    emit_blocks.resize(emit_sources.size());
+    emit_jobs.clear();
+    size_t emitted = 0;
+    for (size_t i = 0; i < emit_sources.size(); ++i) {
+        emit_blocks[i] = free_slots.reserve(emit_counts[i]);
+        size_t count = emit_blocks[i].size();
+        emitted += count;
+        if (count == 0) continue;
+        
+        if (emit_sources[i]->isSequential()) {
+            emit_jobs.push_back({i, 0, count, 0, true});
+            continue;
+        }
+        uint64_t first_stream = emit_sources[i]->claimStreams(count);
+        for (size_t begin = 0; begin < count; begin += EMIT_CHUNK) {
+            emit_jobs.push_back({i, begin, std::min(begin + EMIT_CHUNK, count), first_stream + begin, false});
+        }
+    }
+    
+    // Small batches are filled inline rather than waking workers
+    unsigned int tasks = emitted == 0 ? 0u :
+                         emitted < 1024 ? 1u :
+                         static_cast<unsigned int>(std::min<size_t>(emit_jobs.size(), partition_count));
     
-    // Wait for all threads to finish
-    sync_point.arrive_and_wait();
+    worker_pool->run(tasks, [this](unsigned int task, unsigned int task_count) {
+        size_t first = task * emit_jobs.size() / task_count;
+        size_t last = (task + 1) * emit_jobs.size() / task_count;
+        for (size_t j = first; j < last; ++j) {
+            const EmitJob& job = emit_jobs[j];
+            Emitter& source = *emit_sources[job.source];
+            auto slots = emit_blocks[job.source].subspan(job.begin, job.end - job.begin);
+            if (job.sequential) {
+                source.emit(particles.span(), slots);
+            } else {
+                source.emitRange(particles.span(), slots, job.first_stream);
+            }
+        }
+    });
+    
+    // Bursts have fired, retire them
+    bursts.clear();
+    
+    return emitted + emitChildren();
 }
 
-void ParticleSystem::render(SDL_Renderer* renderer) {
-    for (auto& particle : particles) {
-        if (particle.active) {
-            particle.render(renderer);
+size_t ParticleSystem::emitChildren() {
+    auto child_count = [this](const SpawnRequest& request) -> size_t {
+        return static_cast<size_t>(request.sub_emitter) < sub_emitters.size() ?
+               std::max(sub_emitters[request.sub_emitter].getBurstCount(), 0) : 0;
+    };
+    
+    // Count children in partition order, so every child's slot and random
+    // stream is fixed before the parallel fill
+    size_t total = 0;
+    for (unsigned int id = 0; id < partition_count; ++id) {
+        spawn_offsets[id] = total;
+        const SpawnRequest* requests = spawn_queue.data() + partition_starts[id];
+        for (size_t i = 0; i < worker_spawn_counts[id]; ++i) {
+            total += child_count(requests[i]);
         }
     }
+    if (total == 0) {
+        std::fill(worker_spawn_counts.begin(), worker_spawn_counts.end(), 0);
+        return 0;
+    }
+    
+    // Children share the level of detail of ordinary particles
+    if (budget.enabled) {
+        float pressure = budget.pressure(free_slots.remaining(), particles.size());
+        for (auto& sub_emitter : sub_emitters) {
+            sub_emitter.setLevelOfDetail(budget.lifetimeScale(pressure), budget.sizeScale(pressure));
+        }
+    }
+    
+    // One reservation for every child; those past a full pool are dropped
+    auto slots = free_slots.reserve(total);
+    uint64_t first_stream = child_serial;
+    child_serial += total;
+    
+    unsigned int tasks = total < 1024 ? 1u : partition_count;
+    worker_pool->run(tasks, [&](unsigned int task, unsigned int task_count) {
+        unsigned int first = task * partition_count / task_count;
+        unsigned int last = (task + 1) * partition_count / task_count;
+        for (unsigned int id = first; id < last; ++id) {
+            const SpawnRequest* requests = spawn_queue.data() + partition_starts[id];
+            size_t offset = spawn_offsets[id];
+            for (size_t i = 0; i < worker_spawn_counts[id]; ++i) {
+                size_t count = child_count(requests[i]);
+                size_t begin = std::min(offset, slots.size());
+                size_t end = std::min(offset + count, slots.size());
+                if (end > begin) {
+                    sub_emitters[requests[i].sub_emitter].emitInherited(
+                        particles.span(), slots.subspan(begin, end - begin), requests[i], first_stream + offset);
+                }
+                offset += count;
+            }
+        }
+    });
+    
+    std::fill(worker_spawn_counts.begin(), worker_spawn_counts.end(), 0);
+    return slots.size();
+}
+
+unsigned int ParticleSystem::chooseTaskCount(size_t slots, size_t partitions) const {
+    // Enough tasks that each one carries about TARGET_TASK_NS of work, so
+    // small effects skip the wakeup and sync cost of idle workers. A
+    // partition is never split, so there are at most as many tasks as
+    // partitions to update.
+    float work_ns = slots * ns_per_slot;
+    unsigned int tasks = static_cast<unsigned int>(std::ceil(work_ns / TARGET_TASK_NS));
+    return std::clamp(tasks, 1u, static_cast<unsigned int>(partitions));
+}
+
+const FrameSnapshot& ParticleSystem::cullToView() {
+    float min_x, min_y, max_x, max_y;
+    camera.visibleBounds(min_x, min_y, max_x, max_y);
+    
+    // Largest size any style grows a particle to, so nothing that still
+    // overlaps the view is dropped, plus a screen pixel for rounding
+    float size_scale = 0.0f;
+    for (const auto& style : styles) {
+        size_scale = std::max(size_scale, *std::max_element(style.size.begin(), style.size.end()));
+    }
+    float slack = 1.0f / camera.getZoom();
+    
+    view_snapshot.alpha = front_snapshot.alpha;
+    view_snapshot.view_scale = camera.getZoom();
+    view_snapshot.view_x = camera.getOffsetX();
+    view_snapshot.view_y = camera.getOffsetY();
+    
+    // Each segment compacts into the matching view segment
+    worker_pool->run(partition_count, [&](unsigned int id, unsigned int) {
+        const RenderParticle* in = front_snapshot.particles.data() + front_snapshot.segment_start[id];
+        RenderParticle* out = view_snapshot.particles.data() + view_snapshot.segment_start[id];
+        size_t count = front_snapshot.segment_count[id];
+        float alpha = front_snapshot.alpha;
+        
+        size_t kept = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const RenderParticle& p = in[i];
+            float px, py;
+            p.interpolate(alpha, px, py);
+            float margin = p.size * size_scale + slack;
+            
+            // Always copy, keep only if visible - no unpredictable branch
+            out[kept] = p;
+            kept += (px + margin >= min_x) & (px - margin <= max_x) &
+                    (py + margin >= min_y) & (py - margin <= max_y);
+        }
+        view_snapshot.segment_count[id] = kept;
+    });
+    return view_snapshot;
+}
+
+void ParticleSystem::render(RenderBackend& backend) {
+    backend.draw(cullToView(), styles.data(), *worker_pool);
 }
 
 void ParticleSystem::reset() {
@@ -64,22 +478,114 @@ void ParticleSystem::reset() {
     for (auto& p : particles) {
         p.active = false;
     }
+    time_accumulator = 0.0f;
+    active_count = 0;
+    free_slots.reset(particles.size());
+    for (unsigned int id = 0; id < partition_count; ++id) {
+        size_t start, end;
+        partitionRange(id, start, end);
+        worker_live_counts[id] = 0;
+        worker_free_counts[id] = end - start;
+    }
+    front_snapshot.clear();
+    back_snapshot.clear();
+    view_snapshot.clear();
+    snapshot_captured = false;
+    emitter_serial = 0;
+    child_serial = 0;
+    std::fill(worker_spawn_counts.begin(), worker_spawn_counts.end(), 0);
     
-    // Clear emitters and force fields
+    // Clear emitters, force fields and colliders
     emitters.clear();
+    bursts.clear();
+    sub_emitters.clear();
+    styles.resize(1);
     force_fields.clear();
+    acceleration_cache_valid = false;
+    colliders.clear();
     
-    // Clear spatial grid
+    // Clear spatial grids
     for (auto& cell : spatial_grid) {
         cell.clear();
     }
+    for (auto& cell : collider_grid) {
+        cell.clear();
+    }
+    collider_grid_dirty = false;
 }
 
 size_t ParticleSystem::addEmitter(const EmitterSettings& settings) {
-    emitters.emplace_back(settings);
+    // A burst would fire once and then sit in the list emitting nothing
+    if (settings.burst_count > 0) {
+        addBurst(settings);
+        return NO_EMITTER;
+    }
+    
+    if (settings.particle_size > max_particle_size) {
+        max_particle_size = settings.particle_size;
+        collider_grid_dirty = true;
+    }
+    emitters.push_back(makeEmitter(settings));
     return emitters.size() - 1;
 }
 
+void ParticleSystem::addBurst(const EmitterSettings& settings) {
+    // Without a count the emitter would fall back to its rate and never retire
+    if (settings.burst_count <= 0) return;
+    
+    if (settings.particle_size > max_particle_size) {
+        max_particle_size = settings.particle_size;
+        collider_grid_dirty = true;
+    }
+    bursts.push_back(makeEmitter(settings));
+}
+
+int ParticleSystem::addSubEmitter(const EmitterSettings& settings) {
+    // Particles store the id in 16 bits
+    if (sub_emitters.size() > INT16_MAX) return -1;
+    
+    if (settings.particle_size > max_particle_size) {
+        max_particle_size = settings.particle_size;
+        collider_grid_dirty = true;
+    }
+    sub_emitters.push_back(makeEmitter(settings));
+    return static_cast<int>(sub_emitters.size() - 1);
+}
+
+Emitter ParticleSystem::makeEmitter(const EmitterSettings& settings) {
+    // Explicit seeds win, otherwise derive one from the system seed
+    Emitter emitter = (deterministic && settings.seed == 0) ?
+                      Emitter(settings, deriveSeed(base_seed, emitter_serial++)) :
+                      Emitter(settings);
+    emitter.setStyle(findStyle(settings));
+    return emitter;
+}
+
+uint16_t ParticleSystem::findStyle(const EmitterSettings& settings) {
+    if (settings.color_over_life.empty() && settings.size_over_life.empty()) return 0;
+    
+    // Reuse a style baked from the same curves, e.g. by repeated bursts
+    for (size_t i = 1; i < styles.size(); ++i) {
+        if (styles[i].color_stops == settings.color_over_life &&
+            styles[i].size_stops == settings.size_over_life) {
+            return static_cast<uint16_t>(i);
+        }
+    }
+    
+    // Out of ids - fall back to the default look
+    if (styles.size() > UINT16_MAX) return 0;
+    
+    styles.push_back(bakeStyle(settings.color_over_life, settings.size_over_life));
+    return static_cast<uint16_t>(styles.size() - 1);
+}
+
+void ParticleSystem::setDeterministic(bool enabled, uint64_t seed) {
+    deterministic = enabled;
+    base_seed = seed;
+    emitter_serial = 0;
+    child_serial = 0;
+}
+
 void ParticleSystem::removeEmitter(size_t index) {
     if (index < emitters.size()) {
         emitters.erase(emitters.begin() + index);
@@ -88,19 +594,29 @@ void ParticleSystem::removeEmitter(size_t index) {
 
 size_t ParticleSystem::addForceField(float x, float y, float radius, float strength) {
     force_fields.push_back({x, y, radius, strength});
+    acceleration_cache_valid = false;
     return force_fields.size() - 1;
 }
 
 void ParticleSystem::removeForceField(size_t index) {
     if (index < force_fields.size()) {
         force_fields.erase(force_fields.begin() + index);
+        acceleration_cache_valid = false;
     }
 }
 
 void ParticleSystem::updateForceField(size_t index, float x, float y) {
-    if (index < force_fields.size()) {
+    if (index < force_fields.size() && (force_fields[index].x != x || force_fields[index].y != y)) {
         force_fields[index].x = x;
         force_fields[index].y = y;
+        acceleration_cache_valid = false;
+    }
+}
+
+void ParticleSystem::toggleParticleInteraction(bool enabled) {
+    if (enabled != particle_interaction_enabled) {
+        particle_interaction_enabled = enabled;
+        acceleration_cache_valid = false;
     }
 }
 
@@ -111,60 +627,210 @@ float ParticleSystem::getForceFieldStrength(size_t index) const {
     return 0.0f;
 }
 
-void ParticleSystem::workerFunction(unsigned int id, unsigned int thread_count) {
-    while (running.load()) {
-        // Wait until all threads are ready for next frame
-        sync_point.arrive_and_wait();
+size_t ParticleSystem::addCollider(const Collider& collider) {
+    colliders.push_back(collider);
+    colliders.back().prev_x = collider.x;
+    colliders.back().prev_y = collider.y;
+    collider_grid_dirty = true;
+    return colliders.size() - 1;
+}
+
+size_t ParticleSystem::addCircleCollider(float x, float y, float radius) {
+    Collider collider;
+    collider.type = ColliderType::Circle;
+    collider.x = x;
+    collider.y = y;
+    collider.radius = radius;
+    return addCollider(collider);
+}
+
+size_t ParticleSystem::addBoxCollider(float x, float y, float half_width, float half_height) {
+    Collider collider;
+    collider.type = ColliderType::Box;
+    collider.x = x;
+    collider.y = y;
+    collider.half_width = half_width;
+    collider.half_height = half_height;
+    return addCollider(collider);
+}
+
+size_t ParticleSystem::addCapsuleCollider(float x1, float y1, float x2, float y2, float radius) {
+    Collider collider;
+    collider.type = ColliderType::Capsule;
+    collider.x = x1;
+    collider.y = y1;
+    collider.x2 = x2;
+    collider.y2 = y2;
+    collider.radius = radius;
+    return addCollider(collider);
+}
+
+size_t ParticleSystem::addSdfCollider(std::shared_ptr<const SdfGrid> sdf, float x, float y) {
+    Collider collider;
+    collider.type = ColliderType::SDF;
+    collider.x = x;
+    collider.y = y;
+    collider.sdf = std::move(sdf);
+    return addCollider(collider);
+}
+
+void ParticleSystem::removeCollider(size_t index) {
+    if (index < colliders.size()) {
+        colliders.erase(colliders.begin() + index);
+        collider_grid_dirty = true;
+    }
+}
+
+void ParticleSystem::updateCollider(size_t index, float x, float y) {
+    if (index < colliders.size()) {
+        auto& collider = colliders[index];
         
-        float dt = current_dt.load();
+        // Capsules keep their shape, so move both end points
+        collider.x2 += x - collider.x;
+        collider.y2 += y - collider.y;
+        collider.x = x;
+        collider.y = y;
+        collider_grid_dirty = true;
+    }
+}
+
+void ParticleSystem::partitionRange(unsigned int id, size_t& start_idx, size_t& end_idx) const {
+    size_t particles_per_partition = particles.size() / partition_count;
+    start_idx = id * particles_per_partition;
+    end_idx = (id == partition_count - 1) ? 
+              particles.size() : (id + 1) * particles_per_partition;
+}
+
+void ParticleSystem::updatePartition(unsigned int id) {
+    float dt = current_dt;
+    
+    // Process a subset of particles
+    size_t start_idx, end_idx;
+    partitionRange(id, start_idx, end_idx);
+    
+    // Survivors are written to this thread's snapshot segment when capturing
+    RenderParticle* capture_out = capture_step ?
+                                  back_snapshot.particles.data() + back_snapshot.segment_start[id] : nullptr;
+    
+    // Free slots go to this partition's segment of the slot list
+    uint32_t* free_out = free_slots.segment(start_idx);
+    size_t free_count = 0;
+    
+    // Deaths that fire a sub-emitter go to this partition's spawn segment
+    SpawnRequest* spawn_out = spawn_queue.data() + start_idx;
+    size_t spawn_count = 0;
+    
+    // Update particles in this thread's range with the selected integrator
+    size_t live = 0;
+    switch (integrator) {
+        case IntegratorType::SymplecticEuler:
+            live = updateRange<SymplecticEuler>(start_idx, end_idx, dt, capture_out,
+                                       free_out, free_count, spawn_out, spawn_count);
+            break;
+        case IntegratorType::VelocityVerlet:
+            live = updateRange<VelocityVerlet>(start_idx, end_idx, dt, capture_out,
+                                       free_out, free_count, spawn_out, spawn_count);
+            break;
+        case IntegratorType::MidpointRK2:
+            live = updateRange<MidpointRK2>(start_idx, end_idx, dt, capture_out,
+                                       free_out, free_count, spawn_out, spawn_count);
+            break;
+    }
+    worker_live_counts[id] = live;
+    worker_free_counts[id] = free_count;
+    worker_spawn_counts[id] = spawn_count;
+    if (capture_out) {
+        back_snapshot.segment_count[id] = live;
+    }
+}
+
+// Fused per-particle kernel - forces stay in registers, then integrate, age,
+// retire, precompute the render life ratio, capture render state and collect
+// free slots in one pass
+template <typename Integrator>
+size_t ParticleSystem::updateRange(size_t start_idx, size_t end_idx, float dt, RenderParticle* capture_out,
+                                   uint32_t* free_out, size_t& free_count,
+                                   SpawnRequest* spawn_out, size_t& spawn_count) {
+    size_t live = 0;
+    for (size_t i = start_idx; i < end_idx; ++i) {
+        auto& p = particles[i];
+        if (!p.active) {
+            free_out[free_count++] = static_cast<uint32_t>(i);
+            continue;
+        }
         
-        // Process a subset of particles
-        size_t particles_per_thread = particles.size() / thread_count;
-        size_t start_idx = id * particles_per_thread;
-        size_t end_idx = (id == thread_count - 1) ? 
-                         particles.size() : (id + 1) * particles_per_thread;
+        // Forces at the start of the step, carried over from the end of the
+        // last one when the integrator keeps them
+        float ax, ay;
+        if (Integrator::CACHES_ACCELERATION && reuse_acceleration && p.accel_cached) {
+            ax = p.ax;
+            ay = p.ay;
+        } else {
+            computeAcceleration(i, p.x, p.y, ax, ay);
+        }
         
-        // Update particles in this thread's range
-        for (size_t i = start_idx; i < end_idx; ++i) {
-            auto& p = particles[i];
-            if (p.active) {
-                // Apply forces
-                applyGlobalForces(p);
-                
-                // Update particle physics
-                p.update(dt);
-            }
+        // Remember where this step started for render interpolation
+        p.prev_x = p.x;
+        p.prev_y = p.y;
+        
+        // Extra force evaluations for multi-stage integrators
+        Integrator::integrate(p, ax, ay, dt, [this, i](float x, float y, float& sx, float& sy) {
+            computeAcceleration(i, x, y, sx, sy);
+        });
+        
+        // Update lifetime
+        p.lifetime -= dt;
+        p.life_ratio = p.lifetime / p.max_lifetime;
+        if (p.lifetime <= 0.0f) {
+            p.active = false;
+            free_out[free_count++] = static_cast<uint32_t>(i);
+            
+            // Always write the spawn request, only keep it when the particle
+            // has a sub-emitter - no branch or lock in the kernel
+            spawn_out[spawn_count] = {p.x, p.y, p.vx, p.vy, p.r, p.g, p.b, p.a, p.sub_emitter};
+            spawn_count += p.sub_emitter >= 0;
+            continue;
         }
         
-        // Signal that this thread is done
-        sync_point.arrive_and_wait();
+        // Push out of any overlapping geometry
+        resolveCollisions(p);
+        
+        // Render-relevant state for the back snapshot
+        if (capture_out) {
+            capture_out[live] = {p.x, p.y, p.prev_x, p.prev_y, p.size, p.life_ratio,
+                                 p.r, p.g, p.b, p.a, p.colorful_mode, p.style};
+        }
+        live++;
     }
+    return live;
 }
 
-void ParticleSystem::applyGlobalForces(Particle& particle) {
+void ParticleSystem::computeAcceleration(size_t self_idx, float x, float y, float& ax, float& ay) const {
     // Apply gravity
-    particle.applyForce(0.0f, 98.0f);
+    ax = 0.0f;
+    ay = 98.0f;
     
     // Apply force fields
     for (const auto& field : force_fields) {
         if (!field.active) continue;
         
-        float dx = field.x - particle.x;
-        float dy = field.y - particle.y;
+        float dx = field.x - x;
+        float dy = field.y - y;
         float dist_sq = dx*dx + dy*dy;
         
         if (dist_sq < field.radius * field.radius && dist_sq > 0.01f) {
             float dist = std::sqrt(dist_sq);
             float force = field.strength / dist;
-            particle.applyForce(dx / dist * force, dy / dist * force);
+            ax += dx / dist * force;
+            ay += dy / dist * force;
         }
     }
     
     // Apply particle-to-particle interaction - OPTIMIZED VERSION
     if (particle_interaction_enabled) {
         // Get current particle's grid cell
-        int grid_x = static_cast<int>(particle.x / CELL_SIZE);
-        int grid_y = static_cast<int>(particle.y / CELL_SIZE);
+        int grid_x = static_cast<int>(x / CELL_SIZE);
+        int grid_y = static_cast<int>(y / CELL_SIZE);
         
         // Parameters for interaction
         const float repulsion_radius = 15.0f;
@@ -177,19 +843,17 @@ void ParticleSystem::applyGlobalForces(Particle& particle) {
                 // Get cell index
                 size_t cell_idx = getCellIndex(grid_x + x_offset, grid_y + y_offset);
                 
-                // Check particles in this cell
+                // Check particles in this cell, as of the start of the step
                 const auto& cell_particles = spatial_grid[cell_idx];
-                for (size_t other_idx : cell_particles) {
-                    Particle& other = particles[other_idx];
-                    
-                    // Skip inactive particles and self
-                    if (!other.active || &other == &particle) {
+                for (const auto& other : cell_particles) {
+                    // Skip self
+                    if (other.index == self_idx) {
                         continue;
                     }
                     
                     // Calculate distance
-                    float dx = particle.x - other.x;
-                    float dy = particle.y - other.y;
+                    float dx = x - other.x;
+                    float dy = y - other.y;
                     float dist_sq = dx*dx + dy*dy;
                     
                     // Apply repulsion force if particles are close enough
@@ -197,7 +861,8 @@ void ParticleSystem::applyGlobalForces(Particle& particle) {
                         float dist = std::sqrt(dist_sq);
                         float force = repulsion_strength * (1.0f - dist/repulsion_radius) / dist;
                         
-                        particle.applyForce(dx * force, dy * force);
+                        ax += dx * force;
+                        ay += dy * force;
                     }
                 }
             }
@@ -222,12 +887,83 @@ void ParticleSystem::updateSpatialGrid() {
             // Get cell index
             size_t cell_idx = getCellIndex(grid_x, grid_y);
             
-            // Add particle index to cell (with limit check)
+            // Add particle position to cell (with limit check)
             auto& cell = spatial_grid[cell_idx];
             if (cell.size() < MAX_PARTICLES_PER_CELL) {
-                cell.push_back(i);
+                cell.push_back({p.x, p.y, i});
+            }
+        }
+    }
+}
+
+void ParticleSystem::updateColliders(float dt) {
+    // Derive kinematic velocities from how far each collider moved this frame
+    for (auto& collider : colliders) {
+        if (collider.kinematic && dt > 0.0f) {
+            collider.vx = (collider.x - collider.prev_x) / dt;
+            collider.vy = (collider.y - collider.prev_y) / dt;
+        }
+        collider.prev_x = collider.x;
+        collider.prev_y = collider.y;
+    }
+    
+    if (!collider_grid_dirty) return;
+    collider_grid_dirty = false;
+    
+    for (auto& cell : collider_grid) {
+        cell.clear();
+    }
+    
+    // Insert each collider into every cell its bounds overlap, padded by the
+    // largest particle radius so contacts across a cell border are not missed
+    for (size_t i = 0; i < colliders.size(); ++i) {
+        const auto& collider = colliders[i];
+        if (!collider.active) continue;
+        
+        float min_x, min_y, max_x, max_y;
+        collider.bounds(min_x, min_y, max_x, max_y);
+        if (max_x < min_x || max_y < min_y) continue;
+        
+        int x0 = std::clamp(static_cast<int>(std::floor((min_x - max_particle_size) / CELL_SIZE)), 0, GRID_WIDTH - 1);
+        int y0 = std::clamp(static_cast<int>(std::floor((min_y - max_particle_size) / CELL_SIZE)), 0, GRID_HEIGHT - 1);
+        int x1 = std::clamp(static_cast<int>(std::floor((max_x + max_particle_size) / CELL_SIZE)), 0, GRID_WIDTH - 1);
+        int y1 = std::clamp(static_cast<int>(std::floor((max_y + max_particle_size) / CELL_SIZE)), 0, GRID_HEIGHT - 1);
+        
+        for (int gy = y0; gy <= y1; ++gy) {
+            for (int gx = x0; gx <= x1; ++gx) {
+                collider_grid[getCellIndex(gx, gy)].push_back(i);
             }
         }
     }
 }
+
+void ParticleSystem::resolveCollisions(Particle& particle) {
+    int grid_x = static_cast<int>(particle.x / CELL_SIZE);
+    int grid_y = static_cast<int>(particle.y / CELL_SIZE);
+    
+    // Only colliders overlapping this particle's cell are tested
+    for (size_t collider_idx : collider_grid[getCellIndex(grid_x, grid_y)]) {
+        const auto& collider = colliders[collider_idx];
+        
+        float nx, ny;
+        float dist = collider.signedDistance(particle.x, particle.y, nx, ny);
+        float penetration = particle.size - dist;
+        if (penetration <= 0.0f) continue;
+        
+        // Move back onto the surface
+        particle.x += nx * penetration;
+        particle.y += ny * penetration;
+        
+        // Reflect velocity relative to the (possibly moving) collider
+        float rvx = particle.vx - collider.vx;
+        float rvy = particle.vy - collider.vy;
+        float vn = rvx * nx + rvy * ny;
+        if (vn < 0.0f) {
+            float tx = (rvx - vn * nx) * (1.0f - collider.friction);
+            float ty = (rvy - vn * ny) * (1.0f - collider.friction);
+            particle.vx = tx - vn * collider.restitution * nx + collider.vx;
+            particle.vy = ty - vn * collider.restitution * ny + collider.vy;
+        }
+    }
+}
 // src/system.cpp
@@ -2,9 +2,17 @@
 #pragma once
 #include "particle.hpp"
 #include "emitter.hpp"
+#include "collider.hpp"
+#include "integrator.hpp"
+#include "snapshot.hpp"
+#include "worker_pool.hpp"
+#include "first_touch_buffer.hpp"
+#include "slot_allocator.hpp"
+#include "budget.hpp"
+#include "camera.hpp"
+#include "render_backend.hpp"
 #include <vector>
 #include <thread>
-#include <barrier> // C++20 feature
 #include <atomic>
 
 struct ForceField {
@@ -14,55 +22,235 @@ struct ForceField {
     bool active = true;  // Whether force field is active
 };
 
+// Position captured when the spatial grid is built, so neighbour reads never
+// see a particle that another thread is updating
+struct NeighborSample {
+    float x, y;
+    size_t index;
+};
+
 class ParticleSystem {
 private:
-    std::vector<Particle> particles;
+    FirstTouchBuffer<Particle> particles;
     std::vector<Emitter> emitters;
+    std::vector<Emitter> bursts;            // One-shot emitters, retired after firing
     std::vector<ForceField> force_fields;
+    std::vector<Collider> colliders;
     
     // Spatial partitioning - optimized implementation
     const float CELL_SIZE = 30.0f;
     const size_t MAX_PARTICLES_PER_CELL = 64;
     int GRID_WIDTH;
     int GRID_HEIGHT;
-    std::vector<std::vector<size_t>> spatial_grid;
+    std::vector<std::vector<NeighborSample>> spatial_grid;
     bool particle_interaction_enabled = true;
+    IntegratorType integrator = IntegratorType::SymplecticEuler;
+    
+    // Collider broadphase - collider indices per spatial grid cell
+    std::vector<std::vector<size_t>> collider_grid;
+    bool collider_grid_dirty = false;
+    float max_particle_size = 0.0f;
     
     // Multithreading
-    std::vector<std::jthread> worker_threads; // C++20 auto-joining threads
-    std::barrier<> sync_point;
-    std::atomic<bool> running{true};
-    std::atomic<float> current_dt{0.0f};
+    std::shared_ptr<WorkerPool> worker_pool; // Own pool or one shared between systems
+    unsigned int partition_count;            // Update tasks per step
+    float current_dt = 0.0f;
+    std::vector<size_t> partition_starts;   // First particle index of each partition
+    std::vector<size_t> worker_live_counts; // Per-partition results, summed in partition order
+    std::vector<size_t> worker_free_counts;
+    
+    // Emission - free slots are rebuilt by the kernel and reserved by emitters
+    SlotAllocator free_slots;
+    std::vector<Emitter*> emit_sources;                   // Emitters and bursts this step
+    std::vector<int> emit_counts;                         // Particles due per emitter
+    std::vector<float> emit_priorities;                   // Budget weights per emitter
+    std::vector<std::span<const uint32_t>> emit_blocks;   // Reserved in emitter order
+    
+    // Part of one emitter's block, filled by a single emission task
+    struct EmitJob {
+        size_t source;          // Index into emit_sources and emit_blocks
+        size_t begin, end;      // Range within the block
+        uint64_t first_stream;  // Stream of the first particle, unless sequential
+        bool sequential;        // Whole block through Emitter::emit
+    };
+    static constexpr size_t EMIT_CHUNK = 4096;            // Particles per split job
+    std::vector<EmitJob> emit_jobs;
+    size_t active_count = 0;
+    EmissionBudget budget;                                // Throttling as the pool fills
+    
+    // Sub-emitters - the kernel queues deaths into per-partition segments,
+    // the next emission phase spawns their children in bulk
+    std::vector<Emitter> sub_emitters;
+    FirstTouchBuffer<SpawnRequest> spawn_queue;  // Segments start at partition_starts
+    std::vector<size_t> worker_spawn_counts;
+    std::vector<size_t> spawn_offsets;           // First child of each partition
+    uint64_t child_serial = 0;                   // Random stream of the next child
+    
+    // Adaptive worker count - tasks per step follow the measured kernel cost
+    static constexpr float TARGET_TASK_NS = 50000.0f; // Work that amortizes a wakeup
+    bool adaptive_workers = false;
+    float ns_per_slot = 5.0f;                         // Smoothed kernel cost per slot
+    std::vector<float> task_kernel_ns;                // Kernel time of each task last step
+    std::vector<uint8_t> partition_skipped;           // Empty and untouched by emission this step
+    std::vector<unsigned int> update_list;            // Partitions the update tasks split between them
+    unsigned int active_tasks = 0;                    // Tasks used by the last step
+    
+    // Baked color and size gradients, shared by emitters with equal curves.
+    // Style 0 is the default fade and shrink.
+    std::vector<ParticleStyle> styles;
+    
+    // Render snapshots - workers fill the back one while the front one is drawn
+    FrameSnapshot front_snapshot;
+    FrameSnapshot back_snapshot;
+    bool capture_step = false;       // Whether the current step writes back_snapshot
+    
+    // Cached end-of-step accelerations stay usable until the forces change
+    bool acceleration_cache_valid = false;
+    bool reuse_acceleration = false; // Whether the current step may read the cache
+    bool snapshot_captured = false;  // back_snapshot holds newer state than front
+    
+    // What the renderers draw: the front snapshot minus particles outside
+    // the camera's view, rebuilt for every render
+    Camera camera;
+    FrameSnapshot view_snapshot;
+    
+    // Pipelined frames - simulation runs on pipeline_thread during render
+    bool pipelined = false;
+    float pipeline_dt = 0.0f;
+    std::atomic<bool> pipeline_busy{false};
+    std::jthread pipeline_thread;
+    
+    // Deterministic mode - emitters get seeds derived from base_seed
+    bool deterministic = false;
+    uint64_t base_seed = 0;
+    uint64_t emitter_serial = 0;
+    
+    // Fixed timestep - frame time is consumed in whole steps of fixed_step
+    bool fixed_timestep_enabled = false;
+    float fixed_step = 1.0f / 30.0f;
+    int max_substeps = 4;          // Catch-up budget per update call
+    float time_accumulator = 0.0f;
+    float interpolation_alpha = 1.0f;
     
 public:
     ParticleSystem(size_t max_particles = 10000, 
                    unsigned int thread_count = std::thread::hardware_concurrency(),
                    int screen_width = 1280,
                    int screen_height = 720);
+    
+    // Run update tasks on a pool shared with other systems. If the pool pins
+    // its workers, particle storage is partitioned per worker and first
+    // touched by the worker that owns it.
+    ParticleSystem(size_t max_particles,
+                   std::shared_ptr<WorkerPool> pool,
+                   int screen_width = 1280,
+                   int screen_height = 720);
     ~ParticleSystem();
     
     void update(float dt);
-    void render(SDL_Renderer* renderer);
+    
+    // View used by all render paths; particles outside it are culled before
+    // any draw work
+    void setCamera(const Camera& view) { camera = view; }
+    const Camera& getCamera() const { return camera; }
+    
+    // Draw the last published frame, culled to the camera, with any backend
+    void render(RenderBackend& backend);
+    
+    // Split update for pipelined frames: beginUpdate starts simulating the
+    // next frame, endUpdate waits for it and publishes it for rendering.
+    // Render between the two to overlap drawing with simulation.
+    void beginUpdate(float dt);
+    void endUpdate();
+    void setPipelined(bool enabled);
+    bool isPipelined() const { return pipelined; }
     void reset();
     
-    // Emitter management
+    // Emitter management. Settings with a burst_count are queued as a burst
+    // instead and return NO_EMITTER, which removeEmitter ignores.
+    static constexpr size_t NO_EMITTER = static_cast<size_t>(-1);
     size_t addEmitter(const EmitterSettings& settings);
     void removeEmitter(size_t index);
     
+    // Emit settings.burst_count particles on the next update, then retire.
+    // Does nothing if burst_count is 0 or less.
+    void addBurst(const EmitterSettings& settings);
+    
+    // Register settings to fire when a particle dies: settings.burst_count
+    // children per death. Returns the id for EmitterSettings::sub_emitter,
+    // or -1 once all INT16_MAX + 1 ids are taken.
+    int addSubEmitter(const EmitterSettings& settings);
+    
     // Force field management
     size_t addForceField(float x, float y, float radius, float strength);
     void removeForceField(size_t index);
     void updateForceField(size_t index, float x, float y);
     float getForceFieldStrength(size_t index) const;
     
+    // Collider management
+    size_t addCollider(const Collider& collider);
+    size_t addCircleCollider(float x, float y, float radius);
+    size_t addBoxCollider(float x, float y, float half_width, float half_height);
+    size_t addCapsuleCollider(float x1, float y1, float x2, float y2, float radius);
+    size_t addSdfCollider(std::shared_ptr<const SdfGrid> sdf, float x = 0.0f, float y = 0.0f);
+    void removeCollider(size_t index);
+    void updateCollider(size_t index, float x, float y);
+    
+    // Fixed timestep controls
+    void setFixedTimestep(float step_size, int max_steps_per_update = 4);
+    void disableFixedTimestep();
+    bool isFixedTimestepEnabled() const { return fixed_timestep_enabled; }
+    float getInterpolationAlpha() const { return interpolation_alpha; }
+    
+    // Deterministic mode - the same seed and inputs give bit-identical
+    // results whatever the thread count
+    void setDeterministic(bool enabled, uint64_t seed = 0);
+    bool isDeterministic() const { return deterministic; }
+    
+    // Number of particles alive after the last step
+    size_t getActiveCount() const { return active_count; }
+    
+    // Emission budget - scales emitter rates by priority as the pool fills,
+    // optionally trading lifetime and size for particle count
+    void setEmissionBudget(const EmissionBudget& settings) { budget = settings; }
+    const EmissionBudget& getEmissionBudget() const { return budget; }
+    
+    // Adaptive mode picks how many threads join each step from the measured
+    // kernel cost, leaving the rest parked. Ignored on pinned pools,
+    // whose partitions always stay on their own thread.
+    void setAdaptiveWorkers(bool enabled) { adaptive_workers = enabled; }
+    bool isAdaptiveWorkers() const { return adaptive_workers; }
+    unsigned int getActiveWorkerCount() const { return active_tasks; }
+    
+    // Integration scheme used by the update kernel
+    void setIntegrator(IntegratorType type) { integrator = type; }
+    IntegratorType getIntegrator() const { return integrator; }
+    
     // Particle interaction controls
-    void toggleParticleInteraction(bool enabled) { particle_interaction_enabled = enabled; }
+    void toggleParticleInteraction(bool enabled);
     bool isParticleInteractionEnabled() const { return particle_interaction_enabled; }
     
 private:
-    void workerFunction(unsigned int id, unsigned int thread_count);
-    void applyGlobalForces(Particle& particle);
+    void simulate(float dt);
+    size_t emitParticles(float dt);
+    size_t emitChildren();
+    Emitter makeEmitter(const EmitterSettings& settings);
+    uint16_t findStyle(const EmitterSettings& settings);
+    void step(float dt, bool capture);
+    void publishSnapshot();
+    const FrameSnapshot& cullToView();
+    void pipelineFunction(std::stop_token stop);
+    unsigned int chooseTaskCount(size_t slots, size_t partitions) const;
+    void partitionRange(unsigned int id, size_t& start_idx, size_t& end_idx) const;
+    void updatePartition(unsigned int id);
+    template <typename Integrator>
+    size_t updateRange(size_t start_idx, size_t end_idx, float dt, RenderParticle* capture_out,
+                       uint32_t* free_out, size_t& free_count,
+                       SpawnRequest* spawn_out, size_t& spawn_count);
+    void computeAcceleration(size_t self_idx, float x, float y, float& ax, float& ay) const;
     void updateSpatialGrid();
+    void updateColliders(float dt);
+    void resolveCollisions(Particle& particle);
     
     // Helper for spatial grid
     inline size_t getCellIndex(int x, int y) const {
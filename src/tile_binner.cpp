@@ -0,0 +1,42 @@
+#include "tile_binner.hpp"
+#include <algorithm>
+
+void TileBinner::resize(int target_width, int target_height, size_t segment_count) {
+    width = target_width;
+    height = target_height;
+    tiles_x = (width + TILE_SIZE - 1) / TILE_SIZE;
+    tiles_y = (height + TILE_SIZE - 1) / TILE_SIZE;
+    segments = segment_count;
+    bins.resize(segments * getTileCount());
+}
+
+void TileBinner::tileRect(int tile, int& x0, int& y0, int& x1, int& y1) const {
+    x0 = (tile % tiles_x) * TILE_SIZE;
+    y0 = (tile / tiles_x) * TILE_SIZE;
+    x1 = std::min(x0 + TILE_SIZE, width);
+    y1 = std::min(y0 + TILE_SIZE, height);
+}
+
+void TileBinner::clear(size_t segment) {
+    size_t tile_count = static_cast<size_t>(getTileCount());
+    for (size_t t = 0; t < tile_count; ++t) {
+        bins[segment * tile_count + t].clear();
+    }
+}
+
+void TileBinner::add(size_t segment, uint32_t index, int x0, int y0, int x1, int y1) {
+    // Entirely off screen
+    if (x1 < 0 || y1 < 0 || x0 >= width || y0 >= height) return;
+
+    int tx0 = std::max(x0, 0) / TILE_SIZE;
+    int ty0 = std::max(y0, 0) / TILE_SIZE;
+    int tx1 = std::min(x1, width - 1) / TILE_SIZE;
+    int ty1 = std::min(y1, height - 1) / TILE_SIZE;
+
+    std::vector<uint32_t>* row = bins.data() + segment * getTileCount();
+    for (int ty = ty0; ty <= ty1; ++ty) {
+        for (int tx = tx0; tx <= tx1; ++tx) {
+            row[ty * tiles_x + tx].push_back(index);
+        }
+    }
+}
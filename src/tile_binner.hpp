@@ -0,0 +1,46 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Screen split into TILE_SIZE squares, each listing the particles whose
+// bounding box touches it - the same list-per-cell layout as the spatial
+// grid, at render resolution. Every snapshot segment bins into its own
+// lists, so binning threads need no atomics; a tile's particles are its
+// lists concatenated in segment order, which keeps draw order stable.
+// Rasterizing threads then each own whole tiles and never overlap.
+class TileBinner {
+public:
+    static constexpr int TILE_SIZE = 64;
+
+private:
+    int width = 0, height = 0;
+    int tiles_x = 0, tiles_y = 0;
+    size_t segments = 0;
+    std::vector<std::vector<uint32_t>> bins; // [segment * tile count + tile]
+
+public:
+    // Size the grid for a width x height target binned by segment_count threads
+    void resize(int target_width, int target_height, size_t segment_count);
+
+    int getTileCount() const { return tiles_x * tiles_y; }
+
+    // Pixel rectangle [x0, x1) x [y0, y1) covered by a tile
+    void tileRect(int tile, int& x0, int& y0, int& x1, int& y1) const;
+
+    // Empty one segment's lists before binning it again
+    void clear(size_t segment);
+
+    // List index in every tile overlapped by the inclusive pixel box
+    void add(size_t segment, uint32_t index, int x0, int y0, int x1, int y1);
+
+    template <typename Fn>
+    void forEach(int tile, Fn&& fn) const {
+        size_t tile_count = static_cast<size_t>(getTileCount());
+        for (size_t s = 0; s < segments; ++s) {
+            for (uint32_t index : bins[s * tile_count + tile]) {
+                fn(index);
+            }
+        }
+    }
+};
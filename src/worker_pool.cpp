@@ -0,0 +1,241 @@
+#include "worker_pool.hpp"
+#include <algorithm>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// Hint to the CPU that we are busy-waiting
+static inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+// Cores this process is allowed to run on, in CPU order
+static std::vector<int> allowedCores() {
+    std::vector<int> cores;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) cores.push_back(cpu);
+        }
+    }
+#endif
+    return cores;
+}
+
+// Bind a thread to one core, false if that is not possible
+static bool pinToCore(std::jthread& thread, int core) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    return pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) == 0;
+#else
+    (void)thread;
+    (void)core;
+    return false;
+#endif
+}
+
+WorkerPool::WorkerPool(unsigned int thread_count, bool pin_threads)
+    : worker_count(std::max(1u, thread_count) - 1), // The caller is one of them
+      pinned(false),
+      wakes(worker_count)
+{
+    for (unsigned int i = 1; i <= worker_count; ++i) {
+        threads.emplace_back([this, i](std::stop_token stop) {
+            this->workerLoop(stop, i);
+        });
+    }
+    
+    // Worker i gets the i-th allowed core, leaving the first to the caller.
+    // Affine batches are only used if every worker could be bound.
+    std::vector<int> cores = pin_threads ? allowedCores() : std::vector<int>{};
+    if (!cores.empty() && worker_count > 0) {
+        pinned = true;
+        for (unsigned int i = 1; i <= worker_count; ++i) {
+            pinned = pinToCore(threads[i - 1], cores[i % cores.size()]) && pinned;
+        }
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    // Ask everyone to stop before joining anyone
+    for (auto& thread : threads) {
+        thread.request_stop();
+    }
+    threads.clear();
+}
+
+std::shared_ptr<WorkerPool> WorkerPool::shared() {
+    static std::shared_ptr<WorkerPool> pool = std::make_shared<WorkerPool>();
+    return pool;
+}
+
+void WorkerPool::run(unsigned int task_count, const Task& task, bool affine) {
+    if (task_count == 0) return;
+    if (affine && worker_count > 0) {
+        task_count = std::min({task_count, worker_count, MAX_AFFINE_TASKS});
+    } else {
+        // With no workers the caller is the only thread, so affinity holds
+        affine = false;
+        if (task_count == 1) {
+            // Not worth waking anyone
+            task(0, 1);
+            return;
+        }
+    }
+    
+    Batch batch{&task, task_count, affine};
+    unsigned int first_worker;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        batches.push_back(&batch);
+        first_worker = wake_cursor;
+        wake_cursor = (wake_cursor + 1) % std::max(worker_count, 1u);
+    }
+    
+    if (affine) {
+        // Each task has its own worker
+        for (unsigned int id = 1; id <= task_count; ++id) {
+            wakeWorker(id);
+        }
+    } else {
+        // The caller takes tasks too, so wake at most task_count - 1 idle
+        // workers. Busy ones reach this batch after their current task.
+        unsigned int needed = std::min(task_count - 1, worker_count);
+        for (unsigned int n = 0; n < worker_count && needed > 0; ++n) {
+            unsigned int id = (first_worker + n) % worker_count + 1;
+            if (wakes[id - 1].idle.exchange(false)) {
+                wakeWorker(id);
+                --needed;
+            }
+        }
+    }
+    
+    // Help with our own batch, unless its tasks belong to the workers
+    unsigned int index;
+    while (!affine && claim(&batch, 0, index)) {
+        execute(&batch, index);
+    }
+    
+    // Wait for tasks still running on workers - spin first, then park
+    for (int i = 0; i < SPIN_ITERATIONS && batch.done.load() != task_count; ++i) {
+        cpuRelax();
+    }
+    while (batch.done.load() != task_count) {
+        uint32_t seen = completions.load();
+        if (batch.done.load() == task_count) break;
+        completions.wait(seen);
+    }
+}
+
+bool WorkerPool::tryClaim(Batch* batch, unsigned int thread_id, unsigned int& index) {
+    if (batch->next == batch->count) return false;
+    
+    if (batch->affine) {
+        // Only the task matching this worker; the caller takes none
+        if (thread_id == 0 || thread_id > batch->count) return false;
+        uint64_t bit = uint64_t{1} << (thread_id - 1);
+        if (batch->claimed_mask & bit) return false;
+        batch->claimed_mask |= bit;
+        index = thread_id - 1;
+        batch->next++;
+    } else {
+        index = batch->next++;
+    }
+    return true;
+}
+
+bool WorkerPool::claim(Batch* batch, unsigned int thread_id, unsigned int& index) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!tryClaim(batch, thread_id, index)) return false;
+    
+    // Fully claimed batches leave the list, so nobody touches them afterwards
+    if (batch->next == batch->count) {
+        batches.erase(std::find(batches.begin(), batches.end(), batch));
+    }
+    return true;
+}
+
+bool WorkerPool::claimAny(unsigned int thread_id, Batch*& batch, unsigned int& index) {
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    // Rotate through submitters so their batches interleave
+    for (size_t n = 0; n < batches.size(); ++n) {
+        size_t pos = (cursor + n) % batches.size();
+        batch = batches[pos];
+        if (!tryClaim(batch, thread_id, index)) continue;
+        
+        if (batch->next == batch->count) {
+            batches.erase(batches.begin() + pos);
+            cursor = pos;
+        } else {
+            cursor = pos + 1;
+        }
+        return true;
+    }
+    return false;
+}
+
+void WorkerPool::execute(Batch* batch, unsigned int index) {
+    unsigned int count = batch->count;
+    (*batch->task)(index, count);
+    
+    // The batch may be gone as soon as the last task is counted, so only
+    // pool state is touched after this
+    if (batch->done.fetch_add(1) + 1 == count) {
+        completions.fetch_add(1);
+        completions.notify_all();
+    }
+}
+
+void WorkerPool::wakeWorker(unsigned int thread_id) {
+    Wake& wake = wakes[thread_id - 1];
+    wake.epoch.fetch_add(1);
+    wake.epoch.notify_one();
+}
+
+void WorkerPool::workerLoop(std::stop_token stop, unsigned int thread_id) {
+    Wake& wake = wakes[thread_id - 1];
+    
+    // A stop request bumps the epoch so a parked worker wakes up and exits
+    std::stop_callback on_stop(stop, [this, thread_id]() {
+        wakeWorker(thread_id);
+    });
+    
+    Batch* batch;
+    unsigned int index;
+    while (!stop.stop_requested()) {
+        if (claimAny(thread_id, batch, index)) {
+            execute(batch, index);
+            continue;
+        }
+        
+        // Mark ourselves idle and look again: a submitter either pushed its
+        // batch before this claim, or sees the flag and bumps the epoch read
+        // here
+        uint32_t seen = wake.epoch.load();
+        wake.idle.store(true);
+        if (claimAny(thread_id, batch, index)) {
+            wake.idle.store(false);
+            execute(batch, index);
+            continue;
+        }
+        if (stop.stop_requested()) return;
+        
+        // Nothing to do - spin first, then park
+        for (int i = 0; i < SPIN_ITERATIONS && wake.epoch.load() == seen; ++i) {
+            cpuRelax();
+        }
+        wake.epoch.wait(seen);
+        wake.idle.store(false);
+    }
+}
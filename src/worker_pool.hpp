@@ -0,0 +1,95 @@
+#pragma once
+#include <algorithm>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <functional>
+#include <stop_token>
+
+// Set of worker threads that runs batches of tasks. Any number of threads
+// (for example several ParticleSystems) may submit batches at once; workers
+// take tasks from the active batches round-robin, so they interleave on the
+// same threads. The submitting thread helps with its own batch. Idle workers
+// spin briefly and then park on their own atomic wait (a futex on Linux), so
+// an idle pool costs no CPU, and a submission wakes only as many workers as
+// its batch can use. Destruction requests stop and wakes every worker.
+//
+// Thread 0 is whichever thread calls run(); workers are threads 1..N-1.
+// With pin_threads each worker is bound to one core of the process's allowed
+// CPU set, and affine batches run task i on worker i + 1 every time - never
+// on the unpinned caller - so per-task memory stays on that core's NUMA node.
+class WorkerPool {
+public:
+    // Task signature: task(task_index, task_count)
+    using Task = std::function<void(unsigned int, unsigned int)>;
+    
+    // thread_count is the total number of threads executing tasks, counting
+    // the thread that calls run()
+    explicit WorkerPool(unsigned int thread_count = std::thread::hardware_concurrency(),
+                        bool pin_threads = false);
+    ~WorkerPool();
+    
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+    
+    // Threads that can execute a batch at once, including the caller
+    unsigned int concurrency() const { return worker_count + 1; }
+    
+    // Threads an affine batch spreads over: the workers, or just the caller
+    // if there are none
+    unsigned int affineConcurrency() const { return std::max(worker_count, 1u); }
+    
+    // False unless pinning was asked for and every worker could be bound
+    bool isPinned() const { return pinned; }
+    
+    // Run task(i, task_count) for every i and return once all have finished.
+    // An affine batch runs task i on worker i + 1, so task_count must not
+    // exceed affineConcurrency() or MAX_AFFINE_TASKS.
+    void run(unsigned int task_count, const Task& task, bool affine = false);
+    
+    static constexpr unsigned int MAX_AFFINE_TASKS = 64;
+    
+    // Process-wide pool sized to the machine, for systems that share workers
+    static std::shared_ptr<WorkerPool> shared();
+    
+private:
+    // Busy-wait iterations before parking
+    static constexpr int SPIN_ITERATIONS = 2000;
+    
+    // Lives on the submitter's stack for the duration of run()
+    struct Batch {
+        const Task* task;
+        unsigned int count;
+        bool affine;
+        unsigned int next = 0;               // Claimed tasks, guarded by mutex
+        uint64_t claimed_mask = 0;           // Claimed affine tasks, guarded by mutex
+        std::atomic<unsigned int> done{0};   // Finished tasks
+    };
+    
+    // Where a worker parks, on its own cache line
+    struct alignas(64) Wake {
+        std::atomic<uint32_t> epoch{0};      // Bumped to wake the worker (or stop it)
+        std::atomic<bool> idle{false};       // Set while it has nothing to claim
+    };
+    
+    unsigned int worker_count;
+    bool pinned;
+    std::vector<Wake> wakes;                // Worker i parks on wakes[i - 1]
+    std::vector<std::jthread> threads;      // C++20 auto-joining threads
+    
+    std::mutex mutex;
+    std::vector<Batch*> batches;            // Batches with unclaimed tasks
+    size_t cursor = 0;                      // Round-robin position in batches
+    unsigned int wake_cursor = 0;           // Worker the next wake scan starts at, guarded by mutex
+    
+    std::atomic<uint32_t> completions{0};   // Bumped whenever a batch finishes
+    
+    bool tryClaim(Batch* batch, unsigned int thread_id, unsigned int& index);
+    bool claim(Batch* batch, unsigned int thread_id, unsigned int& index);
+    bool claimAny(unsigned int thread_id, Batch*& batch, unsigned int& index);
+    void execute(Batch* batch, unsigned int index);
+    void wakeWorker(unsigned int thread_id);
+    void workerLoop(std::stop_token stop, unsigned int thread_id);
+};
@@ -0,0 +1,91 @@
+// Headless check that deterministic mode gives bit-identical particle state
+// whatever the worker count. Runs the same seeded scene on pools of 1, 4 and
+// 64 threads and compares a hash of every published particle.
+#include "system.hpp"
+#include <cstdio>
+#include <cstring>
+
+// Hashes the published frame instead of drawing it
+class HashRenderer : public RenderBackend {
+private:
+    uint64_t hash = 1469598103934665603ULL; // FNV-1a
+    size_t count = 0;
+
+    void mix(const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+    }
+
+public:
+    const char* getName() const override { return "hash"; }
+
+    void draw(const FrameSnapshot& view, const ParticleStyle*, WorkerPool&) override {
+        view.forEach([this](const RenderParticle& p) {
+            mix(&p.x, sizeof(float) * 6);
+            mix(&p.r, 4);
+            mix(&p.style, sizeof(p.style));
+            ++count;
+        });
+    }
+
+    uint64_t getHash() const { return hash; }
+    size_t getCount() const { return count; }
+};
+
+static uint64_t runScene(unsigned int threads, size_t& particles_seen) {
+    ParticleSystem system(20000, std::make_shared<WorkerPool>(threads));
+    system.setDeterministic(true, 1234);
+    system.setFixedTimestep(1.0f / 120.0f);
+    system.setIntegrator(IntegratorType::VelocityVerlet);
+    system.toggleParticleInteraction(true);
+
+    // Zoomed out far enough that nothing is culled
+    Camera camera = system.getCamera();
+    camera.setZoom(Camera::MIN_ZOOM);
+    system.setCamera(camera);
+
+    EmitterSettings spark{0, 0, 0, 120, 2, 0.8f, EmitterType::Point, 200, 255, 100, 200, 0, 80, 200, 255};
+    spark.burst_count = 6;
+    int spark_id = system.addSubEmitter(spark);
+
+    EmitterSettings fountain{640, 500, 1500, 200, 3, 2.0f, EmitterType::Circle, 0, 255, 0, 255, 0, 255, 128, 255};
+    fountain.sub_emitter = spark_id;
+    system.addEmitter(fountain);
+
+    EmitterSettings burst{400, 300, 0, 300, 2, 1.5f, EmitterType::Circle, 255, 255, 255, 255, 255, 255, 255, 255};
+    burst.burst_count = 3000;
+    system.addBurst(burst);
+
+    system.addForceField(700, 350, 200, -400);
+    system.addCircleCollider(640, 650, 60);
+
+    HashRenderer hasher;
+    for (int frame = 0; frame < 180; ++frame) {
+        system.update(1.0f / 60.0f);
+        system.render(hasher);
+    }
+    particles_seen = hasher.getCount();
+    return hasher.getHash();
+}
+
+int main() {
+    size_t reference_count = 0;
+    uint64_t reference = runScene(1, reference_count);
+    std::printf("1 thread: %zu particles drawn, hash %016llx\n",
+                reference_count, static_cast<unsigned long long>(reference));
+
+    bool ok = reference_count > 0;
+    for (unsigned int threads : {4u, 64u}) {
+        size_t count = 0;
+        uint64_t hash = runScene(threads, count);
+        std::printf("%u threads: %zu particles drawn, hash %016llx\n",
+                    threads, count, static_cast<unsigned long long>(hash));
+        ok = ok && hash == reference && count == reference_count;
+    }
+
+    std::printf(ok ? "PASS\n" : "FAIL\n");
+    return ok ? 0 : 1;
+}